@@ -6,10 +6,28 @@
  * DATA: 22/10/2025
  */
 
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L // Para fsync e clock_gettime
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h> // Para toupper
+#include <stdarg.h> // Para mensagem()
+#include <stddef.h> // Para offsetof
+#include <time.h>
+
+#ifdef __GLIBC__
+    #include <malloc.h> // Para malloc_usable_size e mallinfo2
+#endif
+
+#ifdef _WIN32
+    #include <io.h> // Para _commit
+#else
+    #include <unistd.h> // Para fsync
+    #include <fcntl.h>  // Para abrir o diretório no fsync após rename
+#endif
 
 // --- 1. ESTRUTURAS DE DADOS ---
 
@@ -41,12 +59,203 @@ typedef struct {
  */
 typedef struct No {
     Item item;
+    int acessos; // Vezes que foi encontrado (política por contagem)
     struct No* proximo;
 } No;
 
+/**
+ * @brief Resultado de inserir_* e remover_*: 0 é sucesso, o resto diz por
+ * que a operação não foi feita (o modo de comandos repassa isso no ERR).
+ */
+typedef enum {
+    RESULTADO_OK = 0,
+    RESULTADO_DUPLICADO,
+    RESULTADO_CHEIO,
+    RESULTADO_NAO_ENCONTRADO,
+    RESULTADO_SEM_MEMORIA,
+    RESULTADO_FALHA_DIARIO
+} ResultadoOperacao;
+
 
 // --- 2. FUNÇÕES AUXILIARES ---
 
+// Quando 1, as operações não imprimem mensagens (usado no replay do diário
+// e no benchmark, onde a saída só atrapalharia).
+static int modo_silencioso = 0;
+
+/**
+ * @brief Nome do resultado como aparece no "motivo=" do modo de comandos.
+ */
+const char* nome_resultado(ResultadoOperacao resultado) {
+    switch (resultado) {
+        case RESULTADO_OK:             return "ok";
+        case RESULTADO_DUPLICADO:      return "duplicado";
+        case RESULTADO_CHEIO:          return "cheio";
+        case RESULTADO_NAO_ENCONTRADO: return "nao_encontrado";
+        case RESULTADO_SEM_MEMORIA:    return "sem_memoria";
+        case RESULTADO_FALHA_DIARIO:   return "falha_diario";
+    }
+    return "?";
+}
+
+/**
+ * @brief printf que respeita o modo silencioso.
+ */
+void mensagem(const char* formato, ...) {
+    if (modo_silencioso) {
+        return;
+    }
+    va_list args;
+    va_start(args, formato);
+    vprintf(formato, args);
+    va_end(args);
+}
+
+/**
+ * @brief Relógio de parede em segundos (para os benchmarks).
+ */
+double agora_segundos() {
+    #ifdef _WIN32
+        return (double)clock() / CLOCKS_PER_SEC;
+    #else
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec + ts.tv_nsec / 1e9;
+    #endif
+}
+
+/**
+ * @brief Categorias de memória dinâmica acompanhadas pelo perfil de memória.
+ */
+typedef enum {
+    MEM_NOS_LISTA = 0,    // Nós da lista encadeada
+    MEM_FILTRO_BLOOM = 1, // Blocos do filtro de Bloom
+    MEM_TEMPORARIO = 2,   // Buffers de vida curta (ex: leitura do snapshot)
+    MEM_CATEGORIAS = 3
+} CategoriaMemoria;
+
+/**
+ * @brief Contadores de uma categoria. "Pedidos" são os bytes que o programa
+ * pediu; "reais" incluem o cabeçalho e o arredondamento do malloc.
+ */
+typedef struct {
+    long alocacoes;
+    long liberacoes;
+    long bytesPedidos;
+    long bytesReais;
+    long picoReais;
+} EstatisticasMemoria;
+
+static EstatisticasMemoria estatMemoria[MEM_CATEGORIAS];
+static long memoriaPicoTotal = 0; // Pico de bytes reais somando as categorias
+
+const char* nome_categoria_memoria(CategoriaMemoria categoria) {
+    switch (categoria) {
+        case MEM_NOS_LISTA:    return "Nos da lista";
+        case MEM_FILTRO_BLOOM: return "Filtro de Bloom";
+        case MEM_TEMPORARIO:   return "Temporario";
+        default:               return "?";
+    }
+}
+
+/**
+ * @brief Bytes que um bloco realmente ocupa no heap.
+ * Na glibc pergunta ao próprio malloc; nos outros casos estima
+ * um cabeçalho de sizeof(size_t) e alinhamento de 16 bytes.
+ */
+size_t memoria_tamanho_real(void* ptr, size_t pedido) {
+    #ifdef __GLIBC__
+        (void)pedido;
+        return malloc_usable_size(ptr) + sizeof(size_t);
+    #else
+        (void)ptr;
+        return (pedido + sizeof(size_t) + 15) / 16 * 16;
+    #endif
+}
+
+long memoria_total_reais() {
+    long total = 0;
+    for (int i = 0; i < MEM_CATEGORIAS; i++) {
+        total += estatMemoria[i].bytesReais;
+    }
+    return total;
+}
+
+/**
+ * @brief Soma os contadores de todas as categorias.
+ * picoReais é o pico do total (não a soma dos picos de cada categoria).
+ */
+EstatisticasMemoria memoria_totais() {
+    EstatisticasMemoria total;
+    memset(&total, 0, sizeof(total));
+    for (int i = 0; i < MEM_CATEGORIAS; i++) {
+        total.alocacoes += estatMemoria[i].alocacoes;
+        total.liberacoes += estatMemoria[i].liberacoes;
+        total.bytesPedidos += estatMemoria[i].bytesPedidos;
+        total.bytesReais += estatMemoria[i].bytesReais;
+    }
+    total.picoReais = memoriaPicoTotal;
+    return total;
+}
+
+/**
+ * @brief Fragmentação real do heap do processo, segundo o próprio malloc.
+ * É a fração da arena (memória que o malloc pegou do sistema) que está livre
+ * mas presa entre blocos em uso, sem contar a sobra no topo que pode ser
+ * devolvida. Só a glibc 2.33+ informa isso (mallinfo2); blocos parados no
+ * tcache da thread contam como em uso, então o valor é um limite inferior.
+ * @return 1 se foi medida, 0 se a plataforma não oferece a informação.
+ */
+int memoria_fragmentacao_heap(long* livrePreso, double* fracao) {
+    #if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+        struct mallinfo2 info = mallinfo2();
+        *livrePreso = (long)(info.fordblks - info.keepcost);
+        *fracao = info.arena > 0 ? (double)*livrePreso / (double)info.arena : 0.0;
+        return 1;
+    #else
+        *livrePreso = 0;
+        *fracao = 0.0;
+        return 0;
+    #endif
+}
+
+/**
+ * @brief malloc/calloc com contabilidade por categoria.
+ * Não guarda cabeçalho próprio: quem libera informa o tamanho pedido.
+ */
+void* memoria_alocar(size_t bytes, int zerar, CategoriaMemoria categoria) {
+    void* ptr = zerar ? calloc(1, bytes) : malloc(bytes);
+    if (ptr == NULL) {
+        return NULL;
+    }
+    EstatisticasMemoria* estat = &estatMemoria[categoria];
+    estat->alocacoes++;
+    estat->bytesPedidos += (long)bytes;
+    estat->bytesReais += (long)memoria_tamanho_real(ptr, bytes);
+    if (estat->bytesReais > estat->picoReais) {
+        estat->picoReais = estat->bytesReais;
+    }
+    long total = memoria_total_reais();
+    if (total > memoriaPicoTotal) {
+        memoriaPicoTotal = total;
+    }
+    return ptr;
+}
+
+/**
+ * @brief free com contabilidade. bytes deve ser o mesmo valor pedido na alocação.
+ */
+void memoria_liberar(void* ptr, size_t bytes, CategoriaMemoria categoria) {
+    if (ptr == NULL) {
+        return;
+    }
+    EstatisticasMemoria* estat = &estatMemoria[categoria];
+    estat->liberacoes++;
+    estat->bytesPedidos -= (long)bytes;
+    estat->bytesReais -= (long)memoria_tamanho_real(ptr, bytes);
+    free(ptr);
+}
+
 /**
  * @brief Limpa o buffer de entrada (stdin)
  * Necessário após usar scanf para ler números ou chars.
@@ -84,6 +293,10 @@ Item criar_item() {
     int idValido = 0;
     int raridadeValida = 0;
 
+    // Zera os bytes depois do '\0' de nome/tipo: o Item vai inteiro para o
+    // diário e o snapshot (e entra no checksum)
+    memset(&novoItem, 0, sizeof(novoItem));
+
     // Validação do ID
     while (!idValido) {
         printf("Digite o ID unico do item: ");
@@ -133,369 +346,2159 @@ void exibir_item(Item item) {
     printf("----------------------------------\n");
 }
 
+
+// --- 3. ALGORITMOS GENÉRICOS (GERADOS POR MACRO) ---
+// Cada macro DEFINIR_* gera uma função para um tipo, uma chave e um
+// comparador específicos. Como CHAVE e COMPARA são macros, o compilador
+// os expande dentro do laço (nada de ponteiro para função): uma ordenação
+// por qualquer campo fica tão rápida quanto uma escrita à mão.
+//
+// CHAVE(elemento) extrai o campo; COMPARA(a, b) devolve <0, 0 ou >0.
+
+#define CHAVE_ID(item)        ((item).id)
+#define CHAVE_RARIDADE(item)  ((item).raridade)
+#define CHAVE_NOME(item)      ((item).nome)
+
+#define COMPARA_NUM(a, b)     (((a) > (b)) - ((a) < (b)))
+#define COMPARA_TEXTO(a, b)   strcmp((a), (b))
+
 /**
- * @brief Função de troca para os algoritmos de ordenação.
+ * @brief Gera: void nome(T* v, int n, long* comparacoes, long* trocas)
+ * Bubble Sort crescente pela chave.
  */
-void trocar(Item* a, Item* b) {
-    Item temp = *a;
-    *a = *b;
-    *b = temp;
-}
+#define DEFINIR_BUBBLE_SORT(nome, T, CHAVE, COMPARA)                        \
+    static void nome(T* v, int n, long* comparacoes, long* trocas) {         \
+        *comparacoes = 0;                                                    \
+        *trocas = 0;                                                         \
+        for (int i = 0; i < n - 1; i++) {                                    \
+            for (int j = 0; j < n - i - 1; j++) {                            \
+                (*comparacoes)++;                                            \
+                if (COMPARA(CHAVE(v[j]), CHAVE(v[j + 1])) > 0) {             \
+                    T temp = v[j];                                           \
+                    v[j] = v[j + 1];                                         \
+                    v[j + 1] = temp;                                         \
+                    (*trocas)++;                                             \
+                }                                                            \
+            }                                                                \
+        }                                                                    \
+    }
+
+/**
+ * @brief Gera: void nome(T* v, int n, long* comparacoes, long* trocas)
+ * Selection Sort crescente pela chave.
+ */
+#define DEFINIR_SELECTION_SORT(nome, T, CHAVE, COMPARA)                     \
+    static void nome(T* v, int n, long* comparacoes, long* trocas) {         \
+        *comparacoes = 0;                                                    \
+        *trocas = 0;                                                         \
+        for (int i = 0; i < n - 1; i++) {                                    \
+            int min_idx = i;                                                 \
+            for (int j = i + 1; j < n; j++) {                                \
+                (*comparacoes)++;                                            \
+                if (COMPARA(CHAVE(v[j]), CHAVE(v[min_idx])) < 0) {           \
+                    min_idx = j;                                             \
+                }                                                            \
+            }                                                                \
+            if (min_idx != i) {                                              \
+                T temp = v[i];                                               \
+                v[i] = v[min_idx];                                           \
+                v[min_idx] = temp;                                           \
+                (*trocas)++;                                                 \
+            }                                                                \
+        }                                                                    \
+    }
+
+/**
+ * @brief Gera: void nome(T* v, int n, long* comparacoes, long* trocas)
+ * Insertion Sort crescente pela chave (cada deslocamento conta como troca).
+ */
+#define DEFINIR_INSERTION_SORT(nome, T, CHAVE, COMPARA)                     \
+    static void nome(T* v, int n, long* comparacoes, long* trocas) {         \
+        *comparacoes = 0;                                                    \
+        *trocas = 0;                                                         \
+        for (int i = 1; i < n; i++) {                                        \
+            T chave = v[i];                                                  \
+            int j = i - 1;                                                   \
+            while (j >= 0) {                                                 \
+                (*comparacoes)++;                                            \
+                if (COMPARA(CHAVE(v[j]), CHAVE(chave)) > 0) {                \
+                    v[j + 1] = v[j];                                         \
+                    (*trocas)++;                                             \
+                    j = j - 1;                                               \
+                } else {                                                     \
+                    break;                                                   \
+                }                                                            \
+            }                                                                \
+            v[j + 1] = chave;                                                \
+        }                                                                    \
+    }
+
+/**
+ * @brief Gera: int nome(T* v, int n, TCHAVE chave, int* comparacoes)
+ * Busca Binária em um vetor ordenado pela chave. Devolve o índice ou -1.
+ * Conta duas comparações por passo (igualdade e menor/maior).
+ */
+#define DEFINIR_BUSCA_BINARIA(nome, T, TCHAVE, CHAVE, COMPARA)              \
+    static int nome(T* v, int n, TCHAVE chave, int* comparacoes) {           \
+        int inicio = 0;                                                      \
+        int fim = n - 1;                                                     \
+        *comparacoes = 0;                                                    \
+        while (inicio <= fim) {                                              \
+            int meio = inicio + (fim - inicio) / 2; /* Evita overflow */     \
+            int resultado = COMPARA(CHAVE(v[meio]), chave);                  \
+            (*comparacoes)++;                                                \
+            if (resultado == 0) {                                            \
+                return meio;                                                 \
+            }                                                                \
+            (*comparacoes)++;                                                \
+            if (resultado < 0) {                                             \
+                inicio = meio + 1;                                           \
+            } else {                                                         \
+                fim = meio - 1;                                              \
+            }                                                                \
+        }                                                                    \
+        return -1;                                                           \
+    }
+
+/**
+ * @brief Gera: TCURSOR nome(TCONT c, TCHAVE chave, int* comparacoes,
+ *                           TCURSOR* anterior, TCURSOR* anteAnterior)
+ * Busca Linear sobre qualquer estrutura que se percorra com um cursor:
+ *   INICIO(c), FIM(c, it), PROXIMO(c, it) e ELEMENTO(c, it).
+ * É a mesma implementação para o vetor (cursor = índice) e para a lista
+ * (cursor = No*). Devolve o cursor do elemento ou NAO_ACHOU; anterior e
+ * anteAnterior (podem ser NULL) recebem os cursores que vieram antes dele.
+ */
+#define DEFINIR_BUSCA_LINEAR(nome, TCONT, TCURSOR, NAO_ACHOU, INICIO, FIM, PROXIMO, ELEMENTO, \
+                             TCHAVE, CHAVE, COMPARA)                        \
+    static TCURSOR nome(TCONT c, TCHAVE chave, int* comparacoes,             \
+                        TCURSOR* anterior, TCURSOR* anteAnterior) {          \
+        TCURSOR ant = NAO_ACHOU;                                             \
+        TCURSOR ant2 = NAO_ACHOU;                                            \
+        *comparacoes = 0;                                                    \
+        for (TCURSOR it = INICIO(c); !FIM(c, it); it = PROXIMO(c, it)) {     \
+            (*comparacoes)++;                                                \
+            if (COMPARA(CHAVE(ELEMENTO(c, it)), chave) == 0) {               \
+                if (anterior != NULL) *anterior = ant;                       \
+                if (anteAnterior != NULL) *anteAnterior = ant2;              \
+                return it;                                                   \
+            }                                                                \
+            ant2 = ant;                                                      \
+            ant = it;                                                        \
+        }                                                                    \
+        return NAO_ACHOU;                                                    \
+    }
 
+// Cursores das duas estruturas do inventário
+#define VETOR_INICIO(v)          0
+#define VETOR_FIM(v, i)          ((i) >= (v)->tamanho)
+#define VETOR_PROXIMO(v, i)      ((i) + 1)
+#define VETOR_ELEMENTO(v, i)     ((v)->itens[i])
 
-// --- 3. OPERAÇÕES DA LISTA VETOR (ESTÁTICA) ---
+#define LISTA_INICIO(l)          (l)
+#define LISTA_FIM(l, no)         ((no) == NULL)
+#define LISTA_PROXIMO(l, no)     ((no)->proximo)
+#define LISTA_ELEMENTO(l, no)    ((no)->item)
 
 /**
- * @brief Inicializa a lista vetor.
+ * @brief Gera: void nome(TNO** lista, long* comparacoes, long* trocas)
+ * Insertion Sort crescente e estável para listas encadeadas, usando os
+ * cursores de lista: PROXIMO(c, no) precisa ser o próprio campo de ligação
+ * (um lvalue). Os nós são religados, não copiados, então ponteiros para eles
+ * (o cache LRU, por exemplo) continuam válidos. Guarda o último nó da parte
+ * ordenada para que uma entrada já em ordem custe uma comparação por nó.
+ * Como no vetor, cada item ultrapassado conta como uma troca.
  */
-void inicializar_vetor(ListaVetor* lista) {
-    lista->tamanho = 0;
-    lista->ordenadoPorID = 0;
-    printf("Inventario (Vetor) inicializado.\n");
+#define DEFINIR_INSERTION_SORT_LISTA(nome, TNO, PROXIMO, ELEMENTO, CHAVE, COMPARA) \
+    static void nome(TNO** lista, long* comparacoes, long* trocas) {         \
+        TNO* ordenada = NULL;                                                \
+        TNO* cauda = NULL;                                                   \
+        long tamanho = 0;                                                    \
+        TNO* atual = *lista;                                                 \
+        *comparacoes = 0;                                                    \
+        *trocas = 0;                                                         \
+        while (atual != NULL) {                                              \
+            TNO* seguinte = PROXIMO(lista, atual);                           \
+            int noFim = cauda == NULL;                                       \
+            if (!noFim) {                                                    \
+                (*comparacoes)++;                                            \
+                noFim = COMPARA(CHAVE(ELEMENTO(lista, cauda)),               \
+                                CHAVE(ELEMENTO(lista, atual))) <= 0;         \
+            }                                                                \
+            if (noFim) {                                                     \
+                PROXIMO(lista, atual) = NULL;                                \
+                if (cauda == NULL) {                                         \
+                    ordenada = atual;                                        \
+                } else {                                                     \
+                    PROXIMO(lista, cauda) = atual;                           \
+                }                                                            \
+                cauda = atual;                                               \
+            } else {                                                         \
+                /* Entra antes do primeiro maior (para antes da cauda) */    \
+                TNO* antes = NULL;                                           \
+                TNO* it = ordenada;                                          \
+                long posicao = 0;                                            \
+                while (it != cauda) {                                        \
+                    (*comparacoes)++;                                        \
+                    if (COMPARA(CHAVE(ELEMENTO(lista, it)),                  \
+                                CHAVE(ELEMENTO(lista, atual))) > 0) {        \
+                        break;                                               \
+                    }                                                        \
+                    antes = it;                                              \
+                    it = PROXIMO(lista, it);                                 \
+                    posicao++;                                               \
+                }                                                            \
+                PROXIMO(lista, atual) = it;                                  \
+                if (antes == NULL) {                                         \
+                    ordenada = atual;                                        \
+                } else {                                                     \
+                    PROXIMO(lista, antes) = atual;                           \
+                }                                                            \
+                *trocas += tamanho - posicao;                                \
+            }                                                                \
+            tamanho++;                                                       \
+            atual = seguinte;                                                \
+        }                                                                    \
+        *lista = ordenada;                                                   \
+    }
+
+// Instâncias usadas pelo inventário (vetor e lista compartilham a busca linear)
+DEFINIR_BUBBLE_SORT(bubble_itens_por_raridade, Item, CHAVE_RARIDADE, COMPARA_NUM)
+DEFINIR_SELECTION_SORT(selection_itens_por_raridade, Item, CHAVE_RARIDADE, COMPARA_NUM)
+DEFINIR_INSERTION_SORT(insertion_itens_por_raridade, Item, CHAVE_RARIDADE, COMPARA_NUM)
+DEFINIR_INSERTION_SORT(insertion_itens_por_id, Item, CHAVE_ID, COMPARA_NUM)
+DEFINIR_INSERTION_SORT(insertion_itens_por_nome, Item, CHAVE_NOME, COMPARA_TEXTO)
+DEFINIR_INSERTION_SORT_LISTA(insertion_nos_por_raridade, No, LISTA_PROXIMO, LISTA_ELEMENTO,
+                             CHAVE_RARIDADE, COMPARA_NUM)
+DEFINIR_INSERTION_SORT_LISTA(insertion_nos_por_id, No, LISTA_PROXIMO, LISTA_ELEMENTO,
+                             CHAVE_ID, COMPARA_NUM)
+DEFINIR_INSERTION_SORT_LISTA(insertion_nos_por_nome, No, LISTA_PROXIMO, LISTA_ELEMENTO,
+                             CHAVE_NOME, COMPARA_TEXTO)
+DEFINIR_BUSCA_BINARIA(binaria_itens_por_id, Item, int, CHAVE_ID, COMPARA_NUM)
+DEFINIR_BUSCA_LINEAR(linear_vetor_por_id, ListaVetor*, int, -1,
+                     VETOR_INICIO, VETOR_FIM, VETOR_PROXIMO, VETOR_ELEMENTO,
+                     int, CHAVE_ID, COMPARA_NUM)
+DEFINIR_BUSCA_LINEAR(linear_lista_por_id, No*, No*, NULL,
+                     LISTA_INICIO, LISTA_FIM, LISTA_PROXIMO, LISTA_ELEMENTO,
+                     int, CHAVE_ID, COMPARA_NUM)
+
+
+// --- 4. DIÁRIO DE ESCRITA ANTECIPADA (WAL) ---
+// Toda inserção/remoção é anotada em um arquivo só de acréscimo (append-only).
+// Ao iniciar, o estado é reconstruído lendo o último snapshot e reaplicando
+// o diário por cima (ver seção 10).
+
+#define DIARIO_LOTE 32                  // Registros agrupados por "group commit"
+#define DIARIO_LIMITE_COMPACTACAO 1000  // Registros no diário antes de compactar
+#define DIARIO_MAGICO 0x4C415752u       // Marca de registro válido ("RWAL")
+
+#define OP_INSERIR 1
+#define OP_REMOVER 2
+
+/**
+ * @brief Política de durabilidade: quando chamar fsync.
+ * Em FSYNC_NUNCA e FSYNC_LOTE os registros esperam no buffer "pendentes" do
+ * próprio processo até o lote encher (ou até diario_descarregar ser chamado):
+ * se o processo cair antes disso, até DIARIO_LOTE - 1 operações já confirmadas
+ * são perdidas. No modo de comandos, "sincronizar" força a gravação.
+ */
+typedef enum {
+    FSYNC_NUNCA = 0,  // Lote gravado sem fsync (queda da máquina perde o que o SO não gravou)
+    FSYNC_LOTE = 1,   // Lote gravado com um único fsync (group commit)
+    FSYNC_SEMPRE = 2  // Cada registro gravado e com fsync antes de confirmar a operação
+} PoliticaFsync;
+
+/**
+ * @brief Registro de tamanho fixo gravado no diário.
+ * Cada registro diz de qual estrutura veio, como o cabeçalho do snapshot,
+ * para que o diário de um vetor não seja reaplicado em uma lista.
+ */
+typedef struct {
+    unsigned int magico;
+    unsigned int sequencia;
+    int operacao;  // OP_INSERIR ou OP_REMOVER
+    int estrutura; // 1 = Vetor, 2 = Lista
+    Item item;     // Na remoção, só o id importa
+    unsigned int checksum;
+} RegistroDiario;
+
+/**
+ * @brief Estado do diário de uma estrutura (vetor ou lista).
+ */
+typedef struct {
+    FILE* arquivo;
+    char caminhoDiario[256];
+    char caminhoSnapshot[256];
+    int estrutura; // 1 = Vetor, 2 = Lista
+    PoliticaFsync politica;
+    RegistroDiario pendentes[DIARIO_LOTE]; // Lote ainda não gravado
+    int qtdPendentes;
+    unsigned int proximaSequencia;
+    long registrosNoArquivo; // Registros gravados desde o último snapshot
+    long fsyncs;
+    int falhou; // 1 após um erro de gravação: novas mutações são recusadas
+} Diario;
+
+// Diário que recebe as mutações (NULL = nada é registrado, ex: durante o replay)
+static Diario* diarioAtivo = NULL;
+
+const char* nome_politica_fsync(PoliticaFsync politica) {
+    switch (politica) {
+        case FSYNC_NUNCA:  return "sem fsync";
+        case FSYNC_LOTE:   return "fsync por lote";
+        case FSYNC_SEMPRE: return "fsync por operacao";
+    }
+    return "?";
 }
 
 /**
- * @brief Insere um item no vetor.
- * @return 1 em caso de sucesso, 0 se o inventário estiver cheio.
+ * @brief Checksum (FNV-1a) de um registro, sem contar o próprio campo checksum.
  */
-int inserir_vetor(ListaVetor* lista, Item item) {
-    if (lista->tamanho >= MAX_ITENS) {
-        printf("Erro: Inventario (Vetor) esta cheio!\n");
+unsigned int checksum_registro(const RegistroDiario* registro) {
+    const unsigned char* bytes = (const unsigned char*)registro;
+    unsigned int hash = 2166136261u;
+    for (size_t i = 0; i < offsetof(RegistroDiario, checksum); i++) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief Força os dados do arquivo até o disco (fflush + fsync).
+ * @return 1 se os dados chegaram ao disco, 0 se o fflush ou o fsync falhou.
+ */
+int sincronizar_arquivo(FILE* arquivo) {
+    if (fflush(arquivo) != 0) {
         return 0;
     }
-    
-    // Verifica se o ID já existe
-    for(int i = 0; i < lista->tamanho; i++) {
-        if(lista->itens[i].id == item.id) {
-            printf("Erro: ID %d ja existe no inventario!\n", item.id);
+    #ifdef _WIN32
+        return _commit(_fileno(arquivo)) == 0;
+    #else
+        return fsync(fileno(arquivo)) == 0;
+    #endif
+}
+
+/**
+ * @brief Força até o disco a entrada de diretório do arquivo (ex: após um
+ * rename), para que a troca de nome sobreviva a uma queda da máquina.
+ * No Windows não há equivalente e a função só devolve sucesso.
+ * @return 1 em caso de sucesso, 0 se o diretório não pôde ser sincronizado.
+ */
+int sincronizar_diretorio(const char* caminho) {
+    #ifdef _WIN32
+        (void)caminho;
+        return 1;
+    #else
+        char diretorio[512];
+        const char* barra = strrchr(caminho, '/');
+        if (barra == NULL) {
+            strcpy(diretorio, ".");
+        } else if (barra == caminho) {
+            strcpy(diretorio, "/");
+        } else if ((size_t)(barra - caminho) < sizeof(diretorio)) {
+            memcpy(diretorio, caminho, (size_t)(barra - caminho));
+            diretorio[barra - caminho] = '\0';
+        } else {
             return 0;
         }
+        int fd = open(diretorio, O_RDONLY);
+        if (fd < 0) {
+            return 0;
+        }
+        int ok = fsync(fd) == 0;
+        close(fd);
+        return ok;
+    #endif
+}
+
+/**
+ * @brief Grava o lote pendente no arquivo (group commit).
+ * Um único write (e no máximo um fsync) cobre todos os registros do lote.
+ * Se a gravação falhar, o lote é descartado e o diário fica marcado como
+ * falho: a partir daí diario_registrar recusa novas mutações.
+ * @return 1 em caso de sucesso, 0 se a gravação falhar.
+ */
+int diario_descarregar(Diario* diario) {
+    if (diario == NULL) {
+        return 1;
+    }
+    if (diario->falhou) {
+        return 0;
+    }
+    if (diario->arquivo == NULL || diario->qtdPendentes == 0) {
+        return 1;
     }
 
-    lista->itens[lista->tamanho] = item;
-    lista->tamanho++;
-    lista->ordenadoPorID = 0; // Inserção desordena a lista
-    printf("Item '%s' (ID: %d) adicionado ao vetor.\n", item.nome, item.id);
+    size_t gravados = fwrite(diario->pendentes, sizeof(RegistroDiario),
+                             diario->qtdPendentes, diario->arquivo);
+    if (gravados != (size_t)diario->qtdPendentes || fflush(diario->arquivo) != 0) {
+        fprintf(stderr, "Erro: Falha ao gravar o diario '%s'! %d operacoes perdidas; "
+                        "novas alteracoes serao recusadas.\n",
+                diario->caminhoDiario, diario->qtdPendentes);
+        diario->falhou = 1;
+        diario->qtdPendentes = 0;
+        return 0;
+    }
+
+    diario->registrosNoArquivo += diario->qtdPendentes;
+    if (diario->politica != FSYNC_NUNCA) {
+        diario->fsyncs++;
+        if (!sincronizar_arquivo(diario->arquivo)) {
+            fprintf(stderr, "Erro: Falha no fsync do diario '%s'! %d operacoes podem nao estar "
+                            "no disco; novas alteracoes serao recusadas.\n",
+                    diario->caminhoDiario, diario->qtdPendentes);
+            diario->falhou = 1;
+            diario->qtdPendentes = 0;
+            return 0;
+        }
+    }
+    diario->qtdPendentes = 0;
     return 1;
 }
 
 /**
- * @brief Lista todos os itens do vetor.
+ * @brief Barreira de durabilidade: grava o lote pendente e faz fsync mesmo
+ * em FSYNC_NUNCA. Uma falha marca o diário como falho.
+ * @return 1 se tudo o que foi registrado até aqui está no disco, 0 se não.
  */
-void listar_vetor(ListaVetor* lista) {
-    if (lista->tamanho == 0) {
-        printf("Inventario (Vetor) esta vazio.\n");
-        return;
+int diario_sincronizar(Diario* diario) {
+    if (!diario_descarregar(diario)) {
+        return 0;
     }
-    printf("\n=== INVENTARIO (VETOR) [%d/%d] ===\n", lista->tamanho, MAX_ITENS);
-    for (int i = 0; i < lista->tamanho; i++) {
-        exibir_item(lista->itens[i]);
+    if (diario == NULL || diario->arquivo == NULL || diario->politica != FSYNC_NUNCA) {
+        return 1; // Nas outras políticas o descarregar já fez o fsync
     }
+    diario->fsyncs++;
+    if (!sincronizar_arquivo(diario->arquivo)) {
+        fprintf(stderr, "Erro: Falha no fsync do diario '%s'! Novas alteracoes serao recusadas.\n",
+                diario->caminhoDiario);
+        diario->falhou = 1;
+        return 0;
+    }
+    return 1;
 }
 
 /**
- * @brief Remove um item do vetor pelo ID.
- * @return 1 em caso de sucesso, 0 se o item não for encontrado.
+ * @brief Anota uma mutação no diário ativo, ANTES de ela ser aplicada.
+ * Com FSYNC_SEMPRE grava na hora; nas outras políticas espera o lote encher.
+ * @return 1 se a operação pode ser aplicada, 0 se o diário falhou
+ * (nesse caso a operação não deve ser feita).
  */
-int remover_vetor(ListaVetor* lista, int id) {
-    int indiceEncontrado = -1;
-    for (int i = 0; i < lista->tamanho; i++) {
-        if (lista->itens[i].id == id) {
-            indiceEncontrado = i;
-            break;
-        }
+int diario_registrar(int operacao, Item item) {
+    if (diarioAtivo == NULL) {
+        return 1; // Sem diário (ex: replay ou modo só em memória)
     }
-
-    if (indiceEncontrado == -1) {
-        printf("Erro: Item com ID %d nao encontrado no vetor.\n", id);
+    if (diarioAtivo->falhou || diarioAtivo->arquivo == NULL) {
         return 0;
     }
-    
-    printf("Item '%s' (ID: %d) removido.\n", lista->itens[indiceEncontrado].nome, id);
-
-    // "Puxa" os elementos para cobrir o buraco
-    for (int i = indiceEncontrado; i < lista->tamanho - 1; i++) {
-        lista->itens[i] = lista->itens[i + 1];
+    if (diarioAtivo->qtdPendentes == DIARIO_LOTE && !diario_descarregar(diarioAtivo)) {
+        return 0;
     }
 
-    lista->tamanho--;
-    // Não podemos garantir a ordenação após a remoção,
-    // embora tecnicamente ela se mantenha.
-    // Para segurança, resetamos o flag.
-    lista->ordenadoPorID = 0; 
+    RegistroDiario* registro = &diarioAtivo->pendentes[diarioAtivo->qtdPendentes];
+    memset(registro, 0, sizeof(RegistroDiario));
+    registro->magico = DIARIO_MAGICO;
+    registro->sequencia = diarioAtivo->proximaSequencia++;
+    registro->operacao = operacao;
+    registro->estrutura = diarioAtivo->estrutura;
+    registro->item = item;
+    registro->checksum = checksum_registro(registro);
+    diarioAtivo->qtdPendentes++;
+
+    if (diarioAtivo->politica == FSYNC_SEMPRE || diarioAtivo->qtdPendentes == DIARIO_LOTE) {
+        return diario_descarregar(diarioAtivo);
+    }
     return 1;
 }
 
-// --- 4. OPERAÇÕES DA LISTA ENCADEADA ---
+
+// --- 5. FILTRO DE BLOOM DOS IDs ---
+// Responde "com certeza não existe" sem percorrer a estrutura. É "blocked":
+// os BLOOM_K bits de um ID ficam todos no mesmo bloco de 64 bytes (uma linha
+// de cache), então cada consulta toca a memória uma única vez.
+// Remoções não apagam bits; o filtro é reconstruído a partir da estrutura
+// quando as remoções acumuladas passam de 1/4 dos IDs (ou quando enche).
+
+#define BLOOM_PALAVRAS_BLOCO 8                     // 8 x 64 bits = 64 bytes
+#define BLOOM_BITS_BLOCO (BLOOM_PALAVRAS_BLOCO * 64)
+#define BLOOM_BITS_POR_ITEM 10                     // ~1% de falsos positivos
+#define BLOOM_K 4                                  // Bits marcados por ID
+#define BLOOM_CAPACIDADE_LISTA 64                  // Capacidade inicial (lista)
+
+typedef struct {
+    unsigned long long palavras[BLOOM_PALAVRAS_BLOCO];
+} BlocoBloom;
+
+typedef struct {
+    BlocoBloom* blocos;    // NULL = filtro desligado (tudo "talvez exista")
+    int qtdBlocos;
+    long capacidade;       // IDs suportados antes de precisar crescer
+    long itens;            // IDs adicionados desde a última reconstrução
+    long removidos;        // Remoções desde a última reconstrução (bits "sujos")
+    long consultas;
+    long negativos;        // Respondidas sem percorrer a estrutura
+    long falsosPositivos;  // Filtro disse "talvez", mas o ID não existia
+    long reconstrucoes;
+} FiltroBloom;
+
+static FiltroBloom filtroIds;
 
 /**
- * @brief Inicializa a lista encadeada.
+ * @brief Espalha os bits do ID (finalizador do splitmix64).
  */
-void inicializar_lista(No** lista) {
-    *lista = NULL;
-    printf("Inventario (Lista Encadeada) inicializado.\n");
+unsigned long long hash_id(int id) {
+    unsigned long long x = (unsigned long long)(unsigned int)id;
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
 }
 
 /**
- * @brief Insere um item na lista encadeada (no início).
- * @return 1 em caso de sucesso, 0 se falhar a alocação.
+ * @brief Esvazia o filtro e o redimensiona para a capacidade pedida.
+ * Se a alocação falhar, o filtro fica desligado (as buscas fazem a varredura).
  */
-int inserir_lista(No** lista, Item item) {
-    // Verifica se o ID já existe
-    No* temp = *lista;
-    while(temp != NULL) {
-        if(temp->item.id == item.id) {
-            printf("Erro: ID %d ja existe no inventario!\n", item.id);
-            return 0;
+void bloom_reiniciar(long capacidade) {
+    if (filtroIds.blocos != NULL) {
+        filtroIds.reconstrucoes++;
+    }
+    memoria_liberar(filtroIds.blocos, filtroIds.qtdBlocos * sizeof(BlocoBloom), MEM_FILTRO_BLOOM);
+    if (capacidade < 1) {
+        capacidade = 1;
+    }
+    filtroIds.qtdBlocos = (int)((capacidade * BLOOM_BITS_POR_ITEM + BLOOM_BITS_BLOCO - 1) / BLOOM_BITS_BLOCO);
+    filtroIds.blocos = (BlocoBloom*)memoria_alocar(filtroIds.qtdBlocos * sizeof(BlocoBloom), 1,
+                                                   MEM_FILTRO_BLOOM);
+    filtroIds.capacidade = filtroIds.blocos != NULL ? capacidade : 0;
+    if (filtroIds.blocos == NULL) {
+        filtroIds.qtdBlocos = 0;
+    }
+    filtroIds.itens = 0;
+    filtroIds.removidos = 0;
+}
+
+void bloom_liberar() {
+    memoria_liberar(filtroIds.blocos, filtroIds.qtdBlocos * sizeof(BlocoBloom), MEM_FILTRO_BLOOM);
+    memset(&filtroIds, 0, sizeof(filtroIds));
+}
+
+/**
+ * @brief Marca os BLOOM_K bits do ID (ou testa se estão todos marcados).
+ * Os 36 bits baixos do hash dão as posições (9 bits cada) dentro do bloco;
+ * os bits altos escolhem o bloco.
+ * @return 1 se todos os bits já estavam marcados.
+ */
+int bloom_bits(int id, int marcar) {
+    unsigned long long h = hash_id(id);
+    BlocoBloom* bloco = &filtroIds.blocos[(h >> 36) % (unsigned long long)filtroIds.qtdBlocos];
+    int todos = 1;
+    for (int i = 0; i < BLOOM_K; i++) {
+        unsigned int bit = (unsigned int)(h >> (9 * i)) & (BLOOM_BITS_BLOCO - 1);
+        unsigned long long mascara = 1ull << (bit & 63);
+        if (!(bloco->palavras[bit >> 6] & mascara)) {
+            todos = 0;
+            if (marcar) {
+                bloco->palavras[bit >> 6] |= mascara;
+            }
         }
-        temp = temp->proximo;
     }
+    return todos;
+}
 
-    // Aloca novo nó
-    No* novoNo = (No*)malloc(sizeof(No));
-    if (novoNo == NULL) {
-        printf("Erro: Falha ao alocar memoria para novo item!\n");
+void bloom_adicionar(int id) {
+    if (filtroIds.blocos == NULL) {
+        return;
+    }
+    bloom_bits(id, 1);
+    filtroIds.itens++;
+}
+
+/**
+ * @brief Consulta o filtro antes de uma varredura.
+ * @return 0 se o ID com certeza não existe, 1 se talvez exista.
+ */
+int bloom_talvez_contem(int id) {
+    if (filtroIds.blocos == NULL) {
+        return 1;
+    }
+    filtroIds.consultas++;
+    if (!bloom_bits(id, 0)) {
+        filtroIds.negativos++;
         return 0;
     }
+    return 1;
+}
 
-    novoNo->item = item;
-    novoNo->proximo = *lista; // O novo nó aponta para o antigo início
-    *lista = novoNo;         // O início da lista agora é o novo nó
+/**
+ * @brief Chamado quando o filtro disse "talvez" e a varredura não achou nada.
+ */
+void bloom_falso_positivo() {
+    if (filtroIds.blocos != NULL) {
+        filtroIds.falsosPositivos++;
+    }
+}
 
-    printf("Item '%s' (ID: %d) adicionado a lista.\n", item.nome, item.id);
-    return 1;
+void bloom_item_removido() {
+    if (filtroIds.blocos != NULL) {
+        filtroIds.removidos++;
+    }
 }
 
 /**
- * @brief Lista todos os itens da lista encadeada.
+ * @brief Indica se o filtro precisa ser reconstruído (cheio ou com muitos bits sujos).
  */
-void listar_lista(No* lista) {
-    if (lista == NULL) {
-        printf("Inventario (Lista Encadeada) esta vazio.\n");
-        return;
+int bloom_precisa_reconstruir() {
+    if (filtroIds.blocos == NULL) {
+        return 0;
     }
+    return filtroIds.itens > filtroIds.capacidade
+        || (filtroIds.removidos >= 16 && filtroIds.removidos * 4 > filtroIds.itens);
+}
 
-    printf("\n=== INVENTARIO (LISTA ENCADEADA) ===\n");
-    No* temp = lista;
-    while (temp != NULL) {
-        exibir_item(temp->item);
-        temp = temp->proximo;
+/**
+ * @brief Reconstrói o filtro a partir dos itens do vetor.
+ */
+void bloom_reconstruir_vetor(ListaVetor* lista) {
+    bloom_reiniciar(MAX_ITENS); // O vetor nunca passa de MAX_ITENS
+    for (int i = 0; i < lista->tamanho; i++) {
+        bloom_adicionar(lista->itens[i].id);
+    }
+}
+
+/**
+ * @brief Reconstrói o filtro a partir dos itens da lista (com folga para crescer).
+ */
+void bloom_reconstruir_lista(No* lista) {
+    long quantidade = 0;
+    for (No* temp = lista; temp != NULL; temp = temp->proximo) {
+        quantidade++;
+    }
+    bloom_reiniciar(quantidade * 2 > BLOOM_CAPACIDADE_LISTA ? quantidade * 2 : BLOOM_CAPACIDADE_LISTA);
+    for (No* temp = lista; temp != NULL; temp = temp->proximo) {
+        bloom_adicionar(temp->item.id);
+    }
+}
+
+/**
+ * @brief Números do filtro, calculados em um só lugar para o menu e o modo
+ * de comandos. "bytes" é o que o bloco ocupa de fato no heap (o mesmo valor
+ * contado no relatório de memória); "bytesBits" é só o espaço dos bits.
+ */
+typedef struct {
+    int ligado;
+    int qtdBlocos;
+    long bytesBits;
+    long bytes;
+    long idsVivos;
+    double bytesPorItem;
+    double taxaFalsosPositivos; // Fração das consultas por IDs ausentes
+} ResumoBloom;
+
+ResumoBloom resumir_bloom() {
+    ResumoBloom resumo;
+    memset(&resumo, 0, sizeof(resumo));
+    resumo.ligado = filtroIds.blocos != NULL;
+    resumo.qtdBlocos = filtroIds.qtdBlocos;
+    resumo.bytesBits = (long)filtroIds.qtdBlocos * (long)sizeof(BlocoBloom);
+    if (resumo.ligado) {
+        resumo.bytes = (long)memoria_tamanho_real(filtroIds.blocos, (size_t)resumo.bytesBits);
+    }
+    resumo.idsVivos = filtroIds.itens - filtroIds.removidos;
+    resumo.bytesPorItem = resumo.idsVivos > 0 ? (double)resumo.bytes / resumo.idsVivos : 0.0;
+    long ausentes = filtroIds.negativos + filtroIds.falsosPositivos;
+    resumo.taxaFalsosPositivos = ausentes > 0 ? (double)filtroIds.falsosPositivos / ausentes : 0.0;
+    return resumo;
+}
+
+/**
+ * @brief Mostra as estatísticas do filtro.
+ */
+void exibir_estatisticas_bloom() {
+    ResumoBloom resumo = resumir_bloom();
+
+    printf("Filtro:                 %s\n", resumo.ligado ? "ligado" : "desligado");
+    printf("Memoria:                %ld bytes (%d blocos de %d bytes, com o cabecalho do malloc)\n",
+           resumo.bytes, resumo.qtdBlocos, (int)sizeof(BlocoBloom));
+    printf("Memoria por item:       %.2f bytes (%.1f bits)\n",
+           resumo.bytesPorItem, 8.0 * resumo.bytesPorItem);
+    printf("IDs / capacidade:       %ld / %ld (%ld removidos pendentes)\n",
+           resumo.idsVivos, filtroIds.capacidade, filtroIds.removidos);
+    printf("Consultas:              %ld\n", filtroIds.consultas);
+    printf("Negativos imediatos:    %ld\n", filtroIds.negativos);
+    printf("Falsos positivos:       %ld (%.2f%% dos IDs ausentes)\n", filtroIds.falsosPositivos,
+           100.0 * resumo.taxaFalsosPositivos);
+    printf("Reconstrucoes:          %ld\n", filtroIds.reconstrucoes);
+}
+
+
+// --- 6. OPERAÇÕES DA LISTA VETOR (ESTÁTICA) ---
+
+/**
+ * @brief Inicializa a lista vetor.
+ */
+void inicializar_vetor(ListaVetor* lista) {
+    lista->tamanho = 0;
+    lista->ordenadoPorID = 0;
+    bloom_reconstruir_vetor(lista);
+    mensagem("Inventario (Vetor) inicializado.\n");
+}
+
+/**
+ * @brief Insere um item no vetor.
+ * @return RESULTADO_OK, ou RESULTADO_CHEIO, _DUPLICADO ou _FALHA_DIARIO.
+ */
+ResultadoOperacao inserir_vetor(ListaVetor* lista, Item item) {
+    if (lista->tamanho >= MAX_ITENS) {
+        mensagem("Erro: Inventario (Vetor) esta cheio!\n");
+        return RESULTADO_CHEIO;
+    }
+    
+    // Verifica se o ID já existe (só varre se o filtro não descartar)
+    if (bloom_talvez_contem(item.id)) {
+        int comparacoes;
+        if (linear_vetor_por_id(lista, item.id, &comparacoes, NULL, NULL) != -1) {
+            mensagem("Erro: ID %d ja existe no inventario!\n", item.id);
+            return RESULTADO_DUPLICADO;
+        }
+        bloom_falso_positivo();
+    }
+
+    if (!diario_registrar(OP_INSERIR, item)) {
+        mensagem("Erro: Diario indisponivel; item nao inserido.\n");
+        return RESULTADO_FALHA_DIARIO;
+    }
+
+    lista->itens[lista->tamanho] = item;
+    lista->tamanho++;
+    lista->ordenadoPorID = 0; // Inserção desordena a lista
+    bloom_adicionar(item.id);
+    mensagem("Item '%s' (ID: %d) adicionado ao vetor.\n", item.nome, item.id);
+    return RESULTADO_OK;
+}
+
+/**
+ * @brief Lista todos os itens do vetor.
+ */
+void listar_vetor(ListaVetor* lista) {
+    if (lista->tamanho == 0) {
+        printf("Inventario (Vetor) esta vazio.\n");
+        return;
+    }
+    printf("\n=== INVENTARIO (VETOR) [%d/%d] ===\n", lista->tamanho, MAX_ITENS);
+    for (int i = 0; i < lista->tamanho; i++) {
+        exibir_item(lista->itens[i]);
+    }
+}
+
+/**
+ * @brief Remove um item do vetor pelo ID.
+ * @return RESULTADO_OK, ou RESULTADO_NAO_ENCONTRADO ou _FALHA_DIARIO.
+ */
+ResultadoOperacao remover_vetor(ListaVetor* lista, int id) {
+    int indiceEncontrado = -1;
+    if (bloom_talvez_contem(id)) {
+        int comparacoes;
+        indiceEncontrado = linear_vetor_por_id(lista, id, &comparacoes, NULL, NULL);
+        if (indiceEncontrado == -1) {
+            bloom_falso_positivo();
+        }
+    }
+
+    if (indiceEncontrado == -1) {
+        mensagem("Erro: Item com ID %d nao encontrado no vetor.\n", id);
+        return RESULTADO_NAO_ENCONTRADO;
+    }
+
+    if (!diario_registrar(OP_REMOVER, lista->itens[indiceEncontrado])) {
+        mensagem("Erro: Diario indisponivel; item nao removido.\n");
+        return RESULTADO_FALHA_DIARIO;
+    }
+    
+    mensagem("Item '%s' (ID: %d) removido.\n", lista->itens[indiceEncontrado].nome, id);
+
+    // "Puxa" os elementos para cobrir o buraco
+    for (int i = indiceEncontrado; i < lista->tamanho - 1; i++) {
+        lista->itens[i] = lista->itens[i + 1];
+    }
+
+    lista->tamanho--;
+    // Não podemos garantir a ordenação após a remoção,
+    // embora tecnicamente ela se mantenha.
+    // Para segurança, resetamos o flag.
+    lista->ordenadoPorID = 0; 
+
+    bloom_item_removido();
+    if (bloom_precisa_reconstruir()) {
+        bloom_reconstruir_vetor(lista);
+    }
+    return RESULTADO_OK;
+}
+
+// --- 7. OPERAÇÕES DA LISTA ENCADEADA ---
+
+#define CACHE_LRU_TAM 8 // Itens recentes guardados no cache da frente
+
+/**
+ * @brief Como a lista se reorganiza a cada item encontrado na busca.
+ */
+typedef enum {
+    AUTO_NENHUMA = 0,      // Lista fica como está
+    AUTO_MOVER_FRENTE = 1, // Item encontrado vai para o início
+    AUTO_TRANSPOR = 2,     // Item encontrado troca de lugar com o anterior
+    AUTO_CONTAGEM = 3      // Lista ordenada pelo número de acessos
+} PoliticaAutoOrganizacao;
+
+/**
+ * @brief Configuração e estatísticas da auto-organização da lista.
+ * O cache LRU guarda ponteiros para os últimos nós encontrados
+ * (cache[0] é o mais recente), checados antes de percorrer a lista.
+ */
+typedef struct {
+    PoliticaAutoOrganizacao politica;
+    int cacheAtivo;
+    No* cache[CACHE_LRU_TAM];
+    int qtdCache;
+    long consultas;
+    long encontrados;
+    long acertosCache;
+    long comparacoesTotais;
+} AutoOrganizacao;
+
+static AutoOrganizacao autoOrg; // Começa zerada: sem política e sem cache
+
+const char* nome_politica_auto(PoliticaAutoOrganizacao politica) {
+    switch (politica) {
+        case AUTO_NENHUMA:      return "nenhuma";
+        case AUTO_MOVER_FRENTE: return "mover para frente";
+        case AUTO_TRANSPOR:     return "transpor";
+        case AUTO_CONTAGEM:     return "contagem";
+    }
+    return "?";
+}
+
+/**
+ * @brief Coloca um nó no início do cache LRU (descartando o mais antigo).
+ */
+void cache_lembrar(No* no) {
+    int pos = 0;
+    while (pos < autoOrg.qtdCache && autoOrg.cache[pos] != no) {
+        pos++;
+    }
+    if (pos == autoOrg.qtdCache) { // Não estava no cache
+        if (autoOrg.qtdCache < CACHE_LRU_TAM) {
+            autoOrg.qtdCache++;
+        }
+        pos = autoOrg.qtdCache - 1;
+    }
+    for (int i = pos; i > 0; i--) {
+        autoOrg.cache[i] = autoOrg.cache[i - 1];
+    }
+    autoOrg.cache[0] = no;
+}
+
+/**
+ * @brief Tira um nó do cache (obrigatório antes de dar free nele).
+ */
+void cache_esquecer(No* no) {
+    for (int i = 0; i < autoOrg.qtdCache; i++) {
+        if (autoOrg.cache[i] == no) {
+            for (int j = i; j < autoOrg.qtdCache - 1; j++) {
+                autoOrg.cache[j] = autoOrg.cache[j + 1];
+            }
+            autoOrg.qtdCache--;
+            return;
+        }
+    }
+}
+
+void cache_limpar() {
+    autoOrg.qtdCache = 0;
+}
+
+void zerar_estatisticas_auto() {
+    autoOrg.consultas = 0;
+    autoOrg.encontrados = 0;
+    autoOrg.acertosCache = 0;
+    autoOrg.comparacoesTotais = 0;
+}
+
+/**
+ * @brief Inicializa a lista encadeada.
+ */
+void inicializar_lista(No** lista) {
+    *lista = NULL;
+    bloom_reconstruir_lista(*lista);
+    mensagem("Inventario (Lista Encadeada) inicializado.\n");
+}
+
+/**
+ * @brief Verifica se o ID já está na lista (sem reorganizar nem contar nas
+ * estatísticas da auto-organização). Consulta o filtro de Bloom antes de varrer.
+ */
+int lista_contem(No* lista, int id) {
+    if (!bloom_talvez_contem(id)) {
+        return 0;
+    }
+    int comparacoes;
+    if (linear_lista_por_id(lista, id, &comparacoes, NULL, NULL) != NULL) {
+        return 1;
+    }
+    bloom_falso_positivo();
+    return 0;
+}
+
+/**
+ * @brief Insere um item na lista encadeada (no início).
+ * @return RESULTADO_OK, ou RESULTADO_DUPLICADO, _SEM_MEMORIA ou _FALHA_DIARIO.
+ */
+ResultadoOperacao inserir_lista(No** lista, Item item) {
+    // Verifica se o ID já existe
+    if (lista_contem(*lista, item.id)) {
+        mensagem("Erro: ID %d ja existe no inventario!\n", item.id);
+        return RESULTADO_DUPLICADO;
+    }
+
+    // Aloca novo nó
+    No* novoNo = (No*)memoria_alocar(sizeof(No), 0, MEM_NOS_LISTA);
+    if (novoNo == NULL) {
+        fprintf(stderr, "Erro: Falha ao alocar memoria para novo item!\n");
+        return RESULTADO_SEM_MEMORIA;
+    }
+
+    if (!diario_registrar(OP_INSERIR, item)) {
+        memoria_liberar(novoNo, sizeof(No), MEM_NOS_LISTA);
+        mensagem("Erro: Diario indisponivel; item nao inserido.\n");
+        return RESULTADO_FALHA_DIARIO;
+    }
+
+    novoNo->item = item;
+    novoNo->acessos = 0;
+    novoNo->proximo = *lista; // O novo nó aponta para o antigo início
+    *lista = novoNo;         // O início da lista agora é o novo nó
+
+    bloom_adicionar(item.id);
+    if (bloom_precisa_reconstruir()) {
+        bloom_reconstruir_lista(*lista); // Filtro cheio: cresce
+    }
+
+    mensagem("Item '%s' (ID: %d) adicionado a lista.\n", item.nome, item.id);
+    return RESULTADO_OK;
+}
+
+/**
+ * @brief Lista todos os itens da lista encadeada.
+ */
+void listar_lista(No* lista) {
+    if (lista == NULL) {
+        printf("Inventario (Lista Encadeada) esta vazio.\n");
+        return;
+    }
+
+    printf("\n=== INVENTARIO (LISTA ENCADEADA) ===\n");
+    No* temp = lista;
+    while (temp != NULL) {
+        exibir_item(temp->item);
+        temp = temp->proximo;
+    }
+}
+
+/**
+ * @brief Remove um item da lista encadeada pelo ID.
+ * @return RESULTADO_OK, ou RESULTADO_NAO_ENCONTRADO ou _FALHA_DIARIO.
+ */
+ResultadoOperacao remover_lista(No** lista, int id) {
+    No* temp = *lista;
+    No* anterior = NULL;
+
+    if (!bloom_talvez_contem(id)) {
+        temp = NULL; // Filtro garante que não existe: nem percorre
+    } else {
+        // Procura o nó a ser removido
+        int comparacoes;
+        temp = linear_lista_por_id(*lista, id, &comparacoes, &anterior, NULL);
+        if (temp == NULL) {
+            bloom_falso_positivo();
+        }
+    }
+
+    if (temp == NULL) {
+        mensagem("Erro: Item com ID %d nao encontrado na lista.\n", id);
+        return RESULTADO_NAO_ENCONTRADO;
+    }
+
+    if (!diario_registrar(OP_REMOVER, temp->item)) {
+        mensagem("Erro: Diario indisponivel; item nao removido.\n");
+        return RESULTADO_FALHA_DIARIO;
+    }
+    
+    mensagem("Item '%s' (ID: %d) removido.\n", temp->item.nome, id);
+
+    // Caso 1: O nó a ser removido é o primeiro da lista
+    if (anterior == NULL) {
+        *lista = temp->proximo;
+    }
+    // Caso 2: O nó está no meio ou no fim
+    else {
+        anterior->proximo = temp->proximo;
+    }
+
+    cache_esquecer(temp);
+    memoria_liberar(temp, sizeof(No), MEM_NOS_LISTA); // Libera a memória do nó removido
+
+    bloom_item_removido();
+    if (bloom_precisa_reconstruir()) {
+        bloom_reconstruir_lista(*lista);
+    }
+    return RESULTADO_OK;
+}
+
+/**
+ * @brief Libera todos os nós da lista encadeada.
+ */
+void liberar_lista(No** lista) {
+    No* temp = *lista;
+    while (temp != NULL) {
+        No* proximo = temp->proximo;
+        memoria_liberar(temp, sizeof(No), MEM_NOS_LISTA);
+        temp = proximo;
+    }
+    *lista = NULL;
+    cache_limpar();
+}
+
+/**
+ * @brief Quanto o inventário custa em memória, por estrutura.
+ */
+typedef struct {
+    int itens;
+    long bytesEstrutura; // Vetor: o struct inteiro; Lista: nós no heap + ponteiro inicial
+    long bytesDados;     // Só os Items em si
+    long bytesControle;  // Vetor: tamanho/flag; Lista: ponteiro e contador de cada nó
+    long bytesCapacidadeLivre; // Vetor: posições reservadas e vazias (0 na lista)
+    long bytesOverheadMalloc;  // Lista: cabeçalho/arredondamento do malloc (0 no vetor)
+    long bytesFiltro;    // Filtro de Bloom
+    long bytesTotal;
+    double bytesPorItem;
+    int heapMedido;      // 0 se a plataforma não informa a fragmentação
+    long heapLivrePreso;
+    double fragmentacaoHeap; // Do processo inteiro (ver memoria_fragmentacao_heap)
+} ResumoMemoria;
+
+ResumoMemoria resumir_memoria(int estrutura, ListaVetor* vetor, No* lista) {
+    ResumoMemoria resumo;
+    memset(&resumo, 0, sizeof(resumo));
+
+    if (estrutura == 1) {
+        resumo.itens = vetor->tamanho;
+        resumo.bytesEstrutura = (long)sizeof(ListaVetor);
+        resumo.bytesDados = (long)(vetor->tamanho * sizeof(Item));
+        resumo.bytesCapacidadeLivre = (long)((MAX_ITENS - vetor->tamanho) * sizeof(Item));
+        resumo.bytesControle = resumo.bytesEstrutura - (long)(MAX_ITENS * sizeof(Item));
+    } else {
+        for (No* temp = lista; temp != NULL; temp = temp->proximo) {
+            resumo.itens++;
+        }
+        EstatisticasMemoria* nos = &estatMemoria[MEM_NOS_LISTA];
+        resumo.bytesEstrutura = nos->bytesReais + (long)sizeof(No*);
+        resumo.bytesDados = (long)(resumo.itens * sizeof(Item));
+        resumo.bytesControle = (long)(resumo.itens * (sizeof(No) - sizeof(Item)) + sizeof(No*));
+        resumo.bytesOverheadMalloc = nos->bytesReais - nos->bytesPedidos;
+    }
+
+    resumo.bytesFiltro = resumir_bloom().bytes;
+    resumo.bytesTotal = resumo.bytesEstrutura + resumo.bytesFiltro;
+    resumo.bytesPorItem = resumo.itens > 0 ? (double)resumo.bytesTotal / resumo.itens : 0.0;
+    resumo.heapMedido = memoria_fragmentacao_heap(&resumo.heapLivrePreso, &resumo.fragmentacaoHeap);
+    return resumo;
+}
+
+/**
+ * @brief Mostra o relatório de memória da estrutura e do heap.
+ */
+void exibir_relatorio_memoria(int estrutura, ListaVetor* vetor, No* lista) {
+    ResumoMemoria resumo = resumir_memoria(estrutura, vetor, lista);
+
+    printf("Estrutura:            %s (%d itens)\n", estrutura == 1 ? "Vetor" : "Lista Encadeada", resumo.itens);
+    printf("Bytes da estrutura:   %ld\n", resumo.bytesEstrutura);
+    printf("  - Dados (Items):    %ld\n", resumo.bytesDados);
+    printf("  - Controle:         %ld\n", resumo.bytesControle);
+    printf("  - Capacidade livre: %ld\n", resumo.bytesCapacidadeLivre);
+    printf("  - Overhead malloc:  %ld\n", resumo.bytesOverheadMalloc);
+    printf("Filtro de Bloom:      %ld\n", resumo.bytesFiltro);
+    printf("Total:                %ld bytes (%.1f bytes por item)\n", resumo.bytesTotal, resumo.bytesPorItem);
+    if (resumo.heapMedido) {
+        printf("Fragmentacao do heap: %.1f%% (%ld bytes livres presos entre blocos)\n",
+               100.0 * resumo.fragmentacaoHeap, resumo.heapLivrePreso);
+    } else {
+        printf("Fragmentacao do heap: nao disponivel nesta plataforma\n");
+    }
+
+    printf("\n%-18s %10s %10s %12s %12s %12s\n", "Heap", "Alocacoes", "Liberacoes", "Pedidos", "Reais", "Pico");
+    for (int i = 0; i < MEM_CATEGORIAS; i++) {
+        EstatisticasMemoria* estat = &estatMemoria[i];
+        printf("%-18s %10ld %10ld %12ld %12ld %12ld\n", nome_categoria_memoria((CategoriaMemoria)i),
+               estat->alocacoes, estat->liberacoes, estat->bytesPedidos, estat->bytesReais, estat->picoReais);
+    }
+    printf("Pico total do heap: %ld bytes\n", memoriaPicoTotal);
+}
+
+
+// --- 8. ALGORITMOS DE BUSCA ---
+// As funções "localizar_*" só procuram (sem imprimir nada) e devolvem a posição;
+// as "busca_*" usam essas funções e mostram o resultado ao usuário.
+
+/**
+ * @brief Localiza um item no vetor por busca linear.
+ * @param comparacoes Ponteiro para contar o número de comparações.
+ * @return O índice do item, ou -1 se não encontrado.
+ */
+int localizar_linear_vetor(ListaVetor* lista, int id, int* comparacoes) {
+    *comparacoes = 0;
+    if (!bloom_talvez_contem(id)) {
+        return -1; // Ausente com certeza: 0 comparações
+    }
+    int indice = linear_vetor_por_id(lista, id, comparacoes, NULL, NULL);
+    if (indice == -1) {
+        bloom_falso_positivo();
+    }
+    return indice;
+}
+
+/**
+ * @brief Reposiciona o nó encontrado conforme a política de auto-organização.
+ * @param anterior Nó antes do encontrado (NULL se ele é o primeiro).
+ * @param anteAnterior Nó antes do anterior (NULL se não existe).
+ */
+void reorganizar_lista(No** lista, No* encontrado, No* anterior, No* anteAnterior) {
+    if (autoOrg.politica == AUTO_CONTAGEM) {
+        encontrado->acessos++;
+    }
+    if (anterior == NULL) {
+        return; // Já é o primeiro
+    }
+
+    switch (autoOrg.politica) {
+        case AUTO_MOVER_FRENTE:
+            anterior->proximo = encontrado->proximo;
+            encontrado->proximo = *lista;
+            *lista = encontrado;
+            break;
+
+        case AUTO_TRANSPOR:
+            anterior->proximo = encontrado->proximo;
+            encontrado->proximo = anterior;
+            if (anteAnterior == NULL) {
+                *lista = encontrado;
+            } else {
+                anteAnterior->proximo = encontrado;
+            }
+            break;
+
+        case AUTO_CONTAGEM: {
+            // Avança o nó para antes do primeiro com menos acessos que ele
+            No* antes = NULL;
+            No* temp = *lista;
+            while (temp != encontrado && temp->acessos >= encontrado->acessos) {
+                antes = temp;
+                temp = temp->proximo;
+            }
+            if (temp == encontrado) {
+                break; // Já está na posição certa
+            }
+            anterior->proximo = encontrado->proximo;
+            encontrado->proximo = temp;
+            if (antes == NULL) {
+                *lista = encontrado;
+            } else {
+                antes->proximo = encontrado;
+            }
+            break;
+        }
+
+        case AUTO_NENHUMA:
+            break;
+    }
+}
+
+/**
+ * @brief Localiza um item na lista encadeada por busca linear.
+ * Consulta primeiro o cache LRU (se ativo) e, ao encontrar o item na lista,
+ * aplica a política de auto-organização. Acumula as estatísticas em autoOrg.
+ * Um acerto no cache não percorre a lista, então não conhece o nó anterior
+ * e não reposiciona nada (mover para frente/transpor não se aplicam); na
+ * política por contagem o acesso ainda é somado, e o nó sobe para a posição
+ * devida na próxima vez que for encontrado na própria lista.
+ * @param comparacoes Ponteiro para contar o número de comparações.
+ * @return O nó do item, ou NULL se não encontrado.
+ */
+No* localizar_linear_lista(No** lista, int id, int* comparacoes) {
+    *comparacoes = 0;
+    autoOrg.consultas++;
+    No* encontrado = NULL;
+
+    if (!bloom_talvez_contem(id)) {
+        return NULL; // Ausente com certeza: nem cache nem lista
+    }
+
+    if (autoOrg.cacheAtivo) {
+        for (int i = 0; i < autoOrg.qtdCache; i++) {
+            (*comparacoes)++;
+            if (autoOrg.cache[i]->item.id == id) {
+                encontrado = autoOrg.cache[i];
+                autoOrg.acertosCache++;
+                if (autoOrg.politica == AUTO_CONTAGEM) {
+                    encontrado->acessos++; // Conta sem reposicionar (ver acima)
+                }
+                cache_lembrar(encontrado);
+                break;
+            }
+        }
+    }
+
+    if (encontrado == NULL) {
+        No* anteAnterior = NULL;
+        No* anterior = NULL;
+        int comparacoesLista;
+        encontrado = linear_lista_por_id(*lista, id, &comparacoesLista, &anterior, &anteAnterior);
+        *comparacoes += comparacoesLista;
+        if (encontrado != NULL) {
+            reorganizar_lista(lista, encontrado, anterior, anteAnterior);
+            if (autoOrg.cacheAtivo) {
+                cache_lembrar(encontrado);
+            }
+        }
+    }
+
+    if (encontrado != NULL) {
+        autoOrg.encontrados++;
+    } else {
+        bloom_falso_positivo();
+    }
+    autoOrg.comparacoesTotais += *comparacoes;
+    return encontrado;
+}
+
+/**
+ * @brief Mostra as estatísticas de busca da lista (para escolher a política).
+ */
+void exibir_estatisticas_auto() {
+    printf("Politica:              %s\n", nome_politica_auto(autoOrg.politica));
+    printf("Cache LRU (%d itens):   %s\n", CACHE_LRU_TAM, autoOrg.cacheAtivo ? "ligado" : "desligado");
+    printf("Consultas:             %ld (%ld encontradas)\n", autoOrg.consultas, autoOrg.encontrados);
+    printf("Acertos no cache:      %ld (%.1f%%)\n", autoOrg.acertosCache,
+           autoOrg.consultas > 0 ? 100.0 * autoOrg.acertosCache / autoOrg.consultas : 0.0);
+    printf("Comparacoes por busca: %.2f\n",
+           autoOrg.consultas > 0 ? (double)autoOrg.comparacoesTotais / autoOrg.consultas : 0.0);
+}
+
+/**
+ * @brief Localiza um item no vetor (ordenado por ID) por busca binária.
+ * @param comparacoes Ponteiro para contar o número de comparações.
+ * @return O índice do item, ou -1 se não encontrado.
+ */
+int localizar_binaria_vetor(ListaVetor* lista, int id, int* comparacoes) {
+    *comparacoes = 0;
+    if (!bloom_talvez_contem(id)) {
+        return -1;
+    }
+    int indice = binaria_itens_por_id(lista->itens, lista->tamanho, id, comparacoes);
+    if (indice == -1) {
+        bloom_falso_positivo();
+    }
+    return indice;
+}
+
+/**
+ * @brief Busca Linear no Vetor.
+ * @param comparacoes Ponteiro para contar o número de comparações.
+ * @return 1 se encontrado, 0 se não.
+ */
+int busca_linear_vetor(ListaVetor* lista, int id, int* comparacoes) {
+    int indice = localizar_linear_vetor(lista, id, comparacoes);
+    if (indice != -1) {
+        printf("Busca Linear (Vetor): Item encontrado!\n");
+        exibir_item(lista->itens[indice]);
+        return 1;
+    }
+    printf("Busca Linear (Vetor): Item com ID %d nao encontrado.\n", id);
+    return 0;
+}
+
+/**
+ * @brief Busca Linear na Lista Encadeada.
+ * @param comparacoes Ponteiro para contar o número de comparações.
+ * @return 1 se encontrado, 0 se não.
+ */
+int busca_linear_lista(No** lista, int id, int* comparacoes) {
+    No* encontrado = localizar_linear_lista(lista, id, comparacoes);
+    if (encontrado != NULL) {
+        printf("Busca Linear (Lista): Item encontrado!\n");
+        exibir_item(encontrado->item);
+        return 1;
+    }
+    printf("Busca Linear (Lista): Item com ID %d nao encontrado.\n", id);
+    return 0;
+}
+
+/**
+ * @brief Busca Binária no Vetor.
+ * @param comparacoes Ponteiro para contar o número de comparações.
+ * @return 1 se encontrado, 0 se não.
+ */
+int busca_binaria_vetor(ListaVetor* lista, int id, int* comparacoes) {
+    int indice = localizar_binaria_vetor(lista, id, comparacoes);
+    if (indice != -1) {
+        printf("Busca Binaria (Vetor): Item encontrado!\n");
+        exibir_item(lista->itens[indice]);
+        return 1;
+    }
+    printf("Busca Binaria (Vetor): Item com ID %d nao encontrado.\n", id);
+    return 0;
+}
+
+
+// --- 9. ALGORITMOS DE ORDENAÇÃO (VETOR E LISTA) ---
+// Os algoritmos em si são gerados na seção 3; aqui só se escolhe a chave.
+
+/**
+ * @brief Ordena o vetor por raridade usando Bubble Sort.
+ */
+void bubbleSort(ListaVetor* lista, long* comparacoes, long* trocas) {
+    bubble_itens_por_raridade(lista->itens, lista->tamanho, comparacoes, trocas);
+    lista->ordenadoPorID = 0; // Lista foi ordenada por raridade
+}
+
+/**
+ * @brief Ordena o vetor por raridade usando Selection Sort.
+ */
+void selectionSort(ListaVetor* lista, long* comparacoes, long* trocas) {
+    selection_itens_por_raridade(lista->itens, lista->tamanho, comparacoes, trocas);
+    lista->ordenadoPorID = 0; // Lista foi ordenada por raridade
+}
+
+/**
+ * @brief Ordena o vetor por raridade usando Insertion Sort.
+ */
+void insertionSort(ListaVetor* lista, long* comparacoes, long* trocas) {
+    insertion_itens_por_raridade(lista->itens, lista->tamanho, comparacoes, trocas);
+    lista->ordenadoPorID = 0; // Lista foi ordenada por raridade
+}
+
+/**
+ * @brief Ordena o vetor por ID (necessário para Busca Binária).
+ * Usaremos o Insertion Sort para esta tarefa.
+ */
+void ordenarPorID(ListaVetor* lista, long* comparacoes, long* trocas) {
+    insertion_itens_por_id(lista->itens, lista->tamanho, comparacoes, trocas);
+    lista->ordenadoPorID = 1; // MARCA o vetor como ordenado por ID
+}
+
+/**
+ * @brief Ordena o vetor por nome (ordem alfabética) usando Insertion Sort.
+ */
+void ordenarPorNome(ListaVetor* lista, long* comparacoes, long* trocas) {
+    insertion_itens_por_nome(lista->itens, lista->tamanho, comparacoes, trocas);
+    lista->ordenadoPorID = 0;
+}
+
+/**
+ * @brief Ordena a lista encadeada por raridade (Insertion Sort, religando os nós).
+ */
+void ordenarListaPorRaridade(No** lista, long* comparacoes, long* trocas) {
+    insertion_nos_por_raridade(lista, comparacoes, trocas);
+}
+
+/**
+ * @brief Ordena a lista encadeada por ID (Insertion Sort, religando os nós).
+ */
+void ordenarListaPorID(No** lista, long* comparacoes, long* trocas) {
+    insertion_nos_por_id(lista, comparacoes, trocas);
+}
+
+/**
+ * @brief Ordena a lista encadeada por nome (Insertion Sort, religando os nós).
+ */
+void ordenarListaPorNome(No** lista, long* comparacoes, long* trocas) {
+    insertion_nos_por_nome(lista, comparacoes, trocas);
+}
+
+
+// --- 10. PERSISTÊNCIA: SNAPSHOT, REPLAY E COMPACTAÇÃO ---
+
+#define SNAPSHOT_MAGICO 0x534E5052u // "RPNS"
+#define SNAPSHOT_VERSAO 1
+
+/**
+ * @brief Cabeçalho do arquivo de snapshot.
+ * ultimaSequencia é o último registro do diário já incluído no snapshot;
+ * no replay, registros com sequência menor ou igual são ignorados.
+ */
+typedef struct {
+    unsigned int magico;
+    int versao;
+    int estrutura; // 1 = Vetor, 2 = Lista
+    int quantidade;
+    unsigned int ultimaSequencia;
+} CabecalhoSnapshot;
+
+/**
+ * @brief Aplica uma operação do diário na estrutura (sem registrá-la de novo).
+ */
+void aplicar_operacao(int estrutura, ListaVetor* vetor, No** lista, int operacao, Item item) {
+    if (operacao == OP_INSERIR) {
+        if (estrutura == 1) {
+            inserir_vetor(vetor, item);
+        } else {
+            inserir_lista(lista, item);
+        }
+    } else if (operacao == OP_REMOVER) {
+        if (estrutura == 1) {
+            remover_vetor(vetor, item.id);
+        } else {
+            remover_lista(lista, item.id);
+        }
+    }
+}
+
+/**
+ * @brief Grava o estado completo em um snapshot.
+ * Escreve em um arquivo temporário e troca pelo definitivo com rename,
+ * para nunca deixar um snapshot pela metade.
+ * @return 1 em caso de sucesso, 0 em caso de erro.
+ */
+int salvar_snapshot(const char* caminho, int estrutura, ListaVetor* vetor, No* lista,
+                    unsigned int ultimaSequencia) {
+    char caminhoTemp[sizeof(((Diario*)0)->caminhoSnapshot) + sizeof(".tmp")];
+    int tamanho = snprintf(caminhoTemp, sizeof(caminhoTemp), "%s.tmp", caminho);
+    if (tamanho < 0 || (size_t)tamanho >= sizeof(caminhoTemp)) {
+        // Um nome cortado poderia coincidir com o próprio snapshot
+        fprintf(stderr, "Erro: Caminho do snapshot '%s' muito longo!\n", caminho);
+        return 0;
+    }
+
+    FILE* arquivo = fopen(caminhoTemp, "wb");
+    if (arquivo == NULL) {
+        fprintf(stderr, "Erro: Nao foi possivel criar o snapshot '%s'!\n", caminhoTemp);
+        return 0;
+    }
+
+    CabecalhoSnapshot cabecalho;
+    memset(&cabecalho, 0, sizeof(cabecalho));
+    cabecalho.magico = SNAPSHOT_MAGICO;
+    cabecalho.versao = SNAPSHOT_VERSAO;
+    cabecalho.estrutura = estrutura;
+    cabecalho.ultimaSequencia = ultimaSequencia;
+
+    int ok = 1;
+    if (estrutura == 1) {
+        cabecalho.quantidade = vetor->tamanho;
+        ok = fwrite(&cabecalho, sizeof(cabecalho), 1, arquivo) == 1
+          && fwrite(vetor->itens, sizeof(Item), vetor->tamanho, arquivo) == (size_t)vetor->tamanho;
+    } else {
+        for (No* temp = lista; temp != NULL; temp = temp->proximo) {
+            cabecalho.quantidade++;
+        }
+        ok = fwrite(&cabecalho, sizeof(cabecalho), 1, arquivo) == 1;
+        for (No* temp = lista; ok && temp != NULL; temp = temp->proximo) {
+            ok = fwrite(&temp->item, sizeof(Item), 1, arquivo) == 1;
+        }
+    }
+
+    if (ok && !sincronizar_arquivo(arquivo)) {
+        ok = 0; // Sem fsync o rename poderia trocar o snapshot bom por um vazio
+    }
+    if (fclose(arquivo) != 0) {
+        ok = 0;
+    }
+    if (!ok) {
+        fprintf(stderr, "Erro: Falha ao gravar o snapshot '%s'!\n", caminhoTemp);
+        remove(caminhoTemp);
+        return 0;
+    }
+
+    #ifdef _WIN32
+        remove(caminho); // rename não sobrescreve no Windows
+    #endif
+    if (rename(caminhoTemp, caminho) != 0) {
+        fprintf(stderr, "Erro: Falha ao substituir o snapshot '%s'!\n", caminho);
+        return 0;
+    }
+    // Sem isto uma queda pode desfazer o rename depois que o diário foi zerado
+    if (!sincronizar_diretorio(caminho)) {
+        fprintf(stderr, "Erro: Falha ao sincronizar o diretorio do snapshot '%s'!\n", caminho);
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief Carrega o snapshot (se existir) para a estrutura vazia.
+ * @return 1 em caso de sucesso (ou sem snapshot), 0 se o arquivo for inválido.
+ * Um snapshot inválido não pode ser ignorado: o diário só tem as operações
+ * posteriores a ele, e compactar em cima disso apagaria o inventário.
+ */
+int carregar_snapshot(const char* caminho, int estrutura, ListaVetor* vetor, No** lista,
+                      unsigned int* ultimaSequencia) {
+    *ultimaSequencia = 0;
+    FILE* arquivo = fopen(caminho, "rb");
+    if (arquivo == NULL) {
+        return 1; // Primeira execução: nada a carregar
+    }
+
+    CabecalhoSnapshot cabecalho;
+    if (fread(&cabecalho, sizeof(cabecalho), 1, arquivo) != 1
+        || cabecalho.magico != SNAPSHOT_MAGICO
+        || cabecalho.versao != SNAPSHOT_VERSAO
+        || cabecalho.estrutura != estrutura
+        || cabecalho.quantidade < 0) {
+        fprintf(stderr, "Erro: Snapshot '%s' invalido!\n", caminho);
+        fclose(arquivo);
+        return 0;
+    }
+
+    Item* itens = NULL;
+    if (cabecalho.quantidade > 0) {
+        itens = (Item*)memoria_alocar(sizeof(Item) * cabecalho.quantidade, 0, MEM_TEMPORARIO);
+        if (itens == NULL
+            || fread(itens, sizeof(Item), cabecalho.quantidade, arquivo) != (size_t)cabecalho.quantidade) {
+            fprintf(stderr, "Erro: Snapshot '%s' incompleto!\n", caminho);
+            memoria_liberar(itens, sizeof(Item) * cabecalho.quantidade, MEM_TEMPORARIO);
+            fclose(arquivo);
+            return 0;
+        }
+    }
+    fclose(arquivo);
+
+    if (estrutura == 1) {
+        for (int i = 0; i < cabecalho.quantidade; i++) {
+            inserir_vetor(vetor, itens[i]);
+        }
+    } else {
+        // A lista insere no início: percorre de trás para frente
+        // para manter a mesma ordem de quando o snapshot foi salvo.
+        for (int i = cabecalho.quantidade - 1; i >= 0; i--) {
+            inserir_lista(lista, itens[i]);
+        }
+    }
+    memoria_liberar(itens, sizeof(Item) * cabecalho.quantidade, MEM_TEMPORARIO);
+
+    *ultimaSequencia = cabecalho.ultimaSequencia;
+    return 1;
+}
+
+/**
+ * @brief Reaplica o diário sobre o estado carregado do snapshot.
+ * Um registro inválido só é aceito como último do arquivo (gravação
+ * interrompida); se houver dados depois dele, o diário está corrompido
+ * no meio e nada é descartado.
+ * @param caudaInvalida Recebe 1 se sobrou lixo no fim do arquivo.
+ * @return Quantidade de registros reaplicados, ou -1 se o meio do arquivo estiver
+ * corrompido ou se o diário for de outra estrutura (como no snapshot).
+ */
+long reaplicar_diario(const char* caminho, int estrutura, ListaVetor* vetor, No** lista,
+                      unsigned int* ultimaSequencia, int* caudaInvalida) {
+    *caudaInvalida = 0;
+    FILE* arquivo = fopen(caminho, "rb");
+    if (arquivo == NULL) {
+        return 0;
+    }
+
+    long reaplicados = 0;
+    long posicao = 0;
+    RegistroDiario registro;
+    size_t lidos;
+    while ((lidos = fread(&registro, 1, sizeof(registro), arquivo)) == sizeof(registro)) {
+        if (registro.magico != DIARIO_MAGICO || registro.checksum != checksum_registro(&registro)) {
+            if (fgetc(arquivo) != EOF) {
+                fprintf(stderr, "Erro: Diario '%s' corrompido no registro %ld (byte %ld)!\n",
+                        caminho, posicao, posicao * (long)sizeof(registro));
+                fclose(arquivo);
+                return -1;
+            }
+            *caudaInvalida = 1; // Último registro: gravação interrompida
+            break;
+        }
+        if (registro.estrutura != estrutura) {
+            fprintf(stderr, "Erro: Diario '%s' foi gravado por outra estrutura (%s)!\n",
+                    caminho, registro.estrutura == 1 ? "vetor" : "lista");
+            fclose(arquivo);
+            return -1;
+        }
+        posicao++;
+        if (registro.sequencia <= *ultimaSequencia) {
+            continue; // Já está no snapshot
+        }
+        aplicar_operacao(estrutura, vetor, lista, registro.operacao, registro.item);
+        *ultimaSequencia = registro.sequencia;
+        reaplicados++;
+    }
+    if (lidos > 0 && lidos < sizeof(registro)) {
+        *caudaInvalida = 1; // Registro cortado no meio
+    }
+
+    fclose(arquivo);
+    return reaplicados;
+}
+
+/**
+ * @brief Descarrega o lote pendente, grava um snapshot novo e zera o diário.
+ * @return 1 em caso de sucesso, 0 em caso de erro.
+ */
+int persistencia_compactar(Diario* diario, ListaVetor* vetor, No* lista) {
+    if (!diario_descarregar(diario)) {
+        return 0;
+    }
+    if (!salvar_snapshot(diario->caminhoSnapshot, diario->estrutura, vetor, lista,
+                         diario->proximaSequencia - 1)) {
+        return 0; // O diário continua intacto: nada é perdido
+    }
+
+    // O snapshot já cobre tudo: o diário pode recomeçar vazio.
+    if (diario->arquivo != NULL) {
+        fclose(diario->arquivo);
+    }
+    diario->arquivo = fopen(diario->caminhoDiario, "wb");
+    if (diario->arquivo == NULL) {
+        fprintf(stderr, "Erro: Nao foi possivel reabrir o diario '%s'!\n", diario->caminhoDiario);
+        diario->falhou = 1;
+        return 0;
+    }
+    diario->registrosNoArquivo = 0;
+    return 1;
+}
+
+/**
+ * @brief Compacta automaticamente quando o diário passa do limite.
+ */
+void persistencia_compactar_se_necessario(Diario* diario, ListaVetor* vetor, No* lista) {
+    if (diario->arquivo != NULL
+        && diario->registrosNoArquivo + diario->qtdPendentes >= DIARIO_LIMITE_COMPACTACAO) {
+        persistencia_compactar(diario, vetor, lista);
+    }
+}
+
+/**
+ * @brief Reconstrói o estado (snapshot + diário) e ativa o diário.
+ * A estrutura já deve estar inicializada (vazia).
+ * @param base Caminho dos arquivos sem extensão: usa "<base>.snap" e "<base>.wal".
+ * @return 1 em caso de sucesso, 0 se os arquivos estiverem corrompidos ou
+ * não for possível abrir o diário. Nesse caso os arquivos não são alterados
+ * e o programa não deve continuar com o inventário parcial.
+ */
+int persistencia_abrir(Diario* diario, const char* base, int estrutura, ListaVetor* vetor,
+                       No** lista, PoliticaFsync politica) {
+    memset(diario, 0, sizeof(Diario));
+    diario->estrutura = estrutura;
+    diario->politica = politica;
+    if (strlen(base) + strlen(".snap") >= sizeof(diario->caminhoSnapshot)) {
+        fprintf(stderr, "Erro: Caminho do diario '%s' muito longo!\n", base);
+        return 0;
+    }
+    snprintf(diario->caminhoSnapshot, sizeof(diario->caminhoSnapshot), "%s.snap", base);
+    snprintf(diario->caminhoDiario, sizeof(diario->caminhoDiario), "%s.wal", base);
+
+    unsigned int ultimaSequencia = 0;
+    int caudaInvalida = 0;
+    long reaplicados = 0;
+
+    int silencioAnterior = modo_silencioso;
+    modo_silencioso = 1;
+    diarioAtivo = NULL; // O replay não pode ser registrado de novo
+    if (carregar_snapshot(diario->caminhoSnapshot, estrutura, vetor, lista, &ultimaSequencia)) {
+        reaplicados = reaplicar_diario(diario->caminhoDiario, estrutura, vetor, lista,
+                                       &ultimaSequencia, &caudaInvalida);
+    } else {
+        reaplicados = -1;
+    }
+    modo_silencioso = silencioAnterior;
+
+    if (reaplicados < 0) {
+        fprintf(stderr, "Erro: Inventario nao restaurado; '%s' e '%s' foram mantidos intactos.\n",
+                diario->caminhoSnapshot, diario->caminhoDiario);
+        return 0;
+    }
+
+    diario->proximaSequencia = ultimaSequencia + 1;
+    diario->registrosNoArquivo = reaplicados;
+
+    if (caudaInvalida) {
+        // Não dá para acrescentar depois de lixo: grava o estado atual
+        // em um snapshot e recomeça o diário do zero.
+        fprintf(stderr, "Aviso: Ultimo registro do diario '%s' incompleto (gravacao interrompida); "
+                        "compactando.\n", diario->caminhoDiario);
+        if (!persistencia_compactar(diario, vetor, *lista)) {
+            return 0;
+        }
+    } else {
+        diario->arquivo = fopen(diario->caminhoDiario, "ab");
+        if (diario->arquivo == NULL) {
+            fprintf(stderr, "Erro: Nao foi possivel abrir o diario '%s'!\n", diario->caminhoDiario);
+            return 0;
+        }
+    }
+
+    diarioAtivo = diario;
+    mensagem("Estado restaurado (%ld operacoes reaplicadas do diario).\n", reaplicados);
+    return 1;
+}
+
+/**
+ * @brief Grava o que estiver pendente e fecha o diário.
+ */
+void persistencia_fechar(Diario* diario) {
+    diario_descarregar(diario);
+    if (diario->arquivo != NULL) {
+        fclose(diario->arquivo);
+        diario->arquivo = NULL;
+    }
+    if (diarioAtivo == diario) {
+        diarioAtivo = NULL;
     }
 }
 
 /**
- * @brief Remove um item da lista encadeada pelo ID.
- * @return 1 em caso de sucesso, 0 se o item não for encontrado.
+ * @brief Mede a vazão de mutações (inserir/remover) em cada política de fsync.
+ * Usa um vetor e arquivos temporários próprios; o inventário real não é tocado.
  */
-int remover_lista(No** lista, int id) {
-    No* temp = *lista;
-    No* anterior = NULL;
-
-    // Procura o nó a ser removido
-    while (temp != NULL && temp->item.id != id) {
-        anterior = temp;
-        temp = temp->proximo;
-    }
+void benchmark_diario(int operacoes) {
+    static ListaVetor vetorTeste; // static: evita ~9 KB na pilha
+    PoliticaFsync politicas[] = { FSYNC_NUNCA, FSYNC_LOTE, FSYNC_SEMPRE };
+    Diario* diarioAnterior = diarioAtivo;
+    int silencioAnterior = modo_silencioso;
+    FiltroBloom filtroAnterior = filtroIds; // O vetor de teste usa um filtro próprio
+
+    memset(&filtroIds, 0, sizeof(filtroIds));
+
+    printf("\n--- Benchmark do Diario (%d mutacoes por politica) ---\n", operacoes);
+    printf("%-20s %12s %14s %10s %12s\n", "Politica", "Tempo (ms)", "Mutacoes/s", "fsyncs", "Compact.(ms)");
+
+    for (int p = 0; p < 3; p++) {
+        Diario diarioTeste;
+        memset(&diarioTeste, 0, sizeof(diarioTeste));
+        diarioTeste.estrutura = 1;
+        diarioTeste.politica = politicas[p];
+        diarioTeste.proximaSequencia = 1;
+        snprintf(diarioTeste.caminhoDiario, sizeof(diarioTeste.caminhoDiario), "benchmark_diario.wal");
+        snprintf(diarioTeste.caminhoSnapshot, sizeof(diarioTeste.caminhoSnapshot), "benchmark_diario.snap");
+        diarioTeste.arquivo = fopen(diarioTeste.caminhoDiario, "wb");
+        if (diarioTeste.arquivo == NULL) {
+            fprintf(stderr, "Erro: Nao foi possivel criar o arquivo do benchmark.\n");
+            break;
+        }
 
-    if (temp == NULL) {
-        printf("Erro: Item com ID %d nao encontrado na lista.\n", id);
-        return 0;
+        modo_silencioso = 1;
+        inicializar_vetor(&vetorTeste);
+        diarioAtivo = &diarioTeste;
+
+        // Alterna inserção e remoção do mesmo ID: o vetor nunca enche
+        // e cada operação gera exatamente um registro no diário.
+        double inicio = agora_segundos();
+        for (int i = 0; i < operacoes; i++) {
+            Item item;
+            memset(&item, 0, sizeof(item));
+            item.id = i / 2 + 1;
+            item.raridade = i % 5 + 1;
+            snprintf(item.nome, sizeof(item.nome), "Item %d", item.id);
+            snprintf(item.tipo, sizeof(item.tipo), "Teste");
+            if (i % 2 == 0) {
+                inserir_vetor(&vetorTeste, item);
+            } else {
+                remover_vetor(&vetorTeste, item.id);
+            }
+        }
+        diario_descarregar(&diarioTeste);
+        double tempo = agora_segundos() - inicio;
+
+        double inicioCompactacao = agora_segundos();
+        persistencia_compactar(&diarioTeste, &vetorTeste, NULL);
+        double tempoCompactacao = agora_segundos() - inicioCompactacao;
+
+        diarioAtivo = diarioAnterior;
+        modo_silencioso = silencioAnterior;
+        persistencia_fechar(&diarioTeste);
+        remove(diarioTeste.caminhoDiario);
+        remove(diarioTeste.caminhoSnapshot);
+
+        printf("%-20s %12.2f %14.0f %10ld %12.2f\n", nome_politica_fsync(politicas[p]),
+               tempo * 1000.0, tempo > 0 ? operacoes / tempo : 0.0,
+               diarioTeste.fsyncs, tempoCompactacao * 1000.0);
     }
-    
-    printf("Item '%s' (ID: %d) removido.\n", temp->item.nome, id);
 
-    // Caso 1: O nó a ser removido é o primeiro da lista
-    if (anterior == NULL) {
-        *lista = temp->proximo;
-    }
-    // Caso 2: O nó está no meio ou no fim
-    else {
-        anterior->proximo = temp->proximo;
-    }
+    diarioAtivo = diarioAnterior;
+    modo_silencioso = silencioAnterior;
+    bloom_liberar();
+    filtroIds = filtroAnterior;
 
-    free(temp); // Libera a memória do nó removido
-    return 1;
+    EstatisticasMemoria total = memoria_totais();
+    printf("Memoria (heap): em uso %ld bytes, pico %ld bytes, %ld alocacoes, %ld liberacoes\n",
+           total.bytesReais, total.picoReais, total.alocacoes, total.liberacoes);
 }
 
 
-// --- 5. ALGORITMOS DE BUSCA ---
+// --- 11. MODO DE COMANDOS (NÃO INTERATIVO) ---
+// Lê um comando por linha (de um arquivo ou da entrada padrão), executa sem
+// limpar a tela nem pausar, e responde uma linha por comando:
+//
+//   inserir <id> <raridade> <tipo> <nome...>  -> OK inserir id=<id>
+//                                                (tipo até 29 e nome até 49 caracteres)
+//   remover <id>                              -> OK remover id=<id>
+//   buscar <id>               (busca linear)  -> OK buscar comparacoes=<n> id=<id> raridade=<r> tipo=<t> nome=<nome>
+//   buscar_binaria <id>       (só vetor)      -> idem
+//   ordenar raridade bubble|selection|insertion  (na lista, só insertion)
+//   ordenar id|nome [insertion]               (outro algoritmo -> motivo=indisponivel)
+//                                             -> OK ordenar chave=<k> algoritmo=<a> comparacoes=<n> trocas=<n>
+//   listar                                    -> OK listar quantidade=<n>, seguido de <n> linhas
+//                                                ITEM id=<id> raridade=<r> tipo=<t> nome=<nome>
+//   politica nenhuma|mover_frente|transpor|contagem  (só lista)  -> OK politica nome=<p>
+//   cache ligado|desligado                    (só lista)  -> OK cache estado=<e>
+//   estatisticas                              (só lista)
+//                                             -> OK estatisticas politica=<p> cache=<e> consultas=<n>
+//                                                encontrados=<n> acertos_cache=<n> taxa_acerto=<x> comparacoes_media=<x>
+//   bloom                                     -> OK bloom bytes=<n> bytes_bits=<n> bytes_por_item=<x> consultas=<n>
+//                                                negativos=<n> falsos_positivos=<n> taxa_fp=<x> reconstrucoes=<n>
+//   memoria                                   -> OK memoria itens=<n> bytes_estrutura=<n> bytes_dados=<n>
+//                                                bytes_controle=<n> bytes_capacidade_livre=<n> bytes_overhead_malloc=<n>
+//                                                bytes_filtro=<n> bytes_total=<n> bytes_por_item=<x> alocacoes=<n>
+//                                                liberacoes=<n> heap_em_uso=<n> heap_pico=<n> fragmentacao_heap=<x>
+//                                                (fragmentacao_heap=-1 onde o malloc não informa)
+//   sincronizar                               -> OK sincronizar (tudo confirmado até aqui está no disco)
+//   sair                                      -> OK sair
+//
+// Por padrão o inventário vive só na memória e cada execução começa vazia,
+// para que o mesmo roteiro produza sempre a mesma saída. Com --diario <base>
+// o estado é restaurado de "<base>.snap" + "<base>.wal" e as alterações são
+// registradas ali.
+//
+// Durabilidade (com --diario): o "OK" de inserir/remover confirma que a operação foi
+// aplicada e anotada no diário, mas com --fsync nunca|lote o registro pode
+// ainda estar no lote em memória (ver PoliticaFsync): uma queda do processo
+// perde até DIARIO_LOTE - 1 operações confirmadas. Para ter uma barreira de
+// commit, envie "sincronizar" e espere o OK; com --fsync sempre cada OK já é durável.
+//
+// Falhas respondem "ERR <comando> ... motivo=<motivo>"; diagnósticos para
+// humanos (falha de disco, de alocação) vão só para stderr, nunca para a
+// saída padrão, que contém apenas o protocolo. Linhas vazias e
+// iniciadas por '#' são ignoradas. O nome fica sempre por último porque
+// pode conter espaços. Ao final é impressa uma linha "FIM" com o resumo
+// (inclusive o pico de memória do heap, para comparar as estruturas).
+
+#define COMANDO_MAX_LINHA 256
 
 /**
- * @brief Busca Linear no Vetor.
- * @param comparacoes Ponteiro para contar o número de comparações.
- * @return 1 se encontrado, 0 se não.
+ * @brief Imprime um item no formato do modo de comandos (sem quebra de linha).
  */
-int busca_linear_vetor(ListaVetor* lista, int id, int* comparacoes) {
-    *comparacoes = 0;
-    for (int i = 0; i < lista->tamanho; i++) {
-        (*comparacoes)++; // Conta cada checagem de ID
-        if (lista->itens[i].id == id) {
-            printf("Busca Linear (Vetor): Item encontrado!\n");
-            exibir_item(lista->itens[i]);
-            return 1;
-        }
-    }
-    printf("Busca Linear (Vetor): Item com ID %d nao encontrado.\n", id);
-    return 0;
+void responder_item(Item item) {
+    printf("id=%d raridade=%d tipo=%s nome=%s", item.id, item.raridade, item.tipo, item.nome);
 }
 
 /**
- * @brief Busca Linear na Lista Encadeada.
- * @param comparacoes Ponteiro para contar o número de comparações.
- * @return 1 se encontrado, 0 se não.
+ * @brief Executa uma linha do protocolo.
+ * @return 1 se o comando deu certo, 0 se respondeu ERR, -1 para "sair".
  */
-int busca_linear_lista(No* lista, int id, int* comparacoes) {
-    *comparacoes = 0;
-    No* temp = lista;
-    while (temp != NULL) {
-        (*comparacoes)++; // Conta cada checagem de ID
-        if (temp->item.id == id) {
-            printf("Busca Linear (Lista): Item encontrado!\n");
-            exibir_item(temp->item);
+int executar_comando(char* linha, int estrutura, ListaVetor* vetor, No** lista) {
+    char comando[32];
+    int lidos = 0;
+    int id;
+    int comparacoes = 0;
+
+    linha[strcspn(linha, "\r\n")] = 0;
+    if (sscanf(linha, "%31s%n", comando, &lidos) != 1 || comando[0] == '#') {
+        return 1; // Linha vazia ou comentário
+    }
+    char* argumentos = linha + lidos;
+
+    if (strcmp(comando, "inserir") == 0) {
+        Item item;
+        int inicioTipo = 0, fimTipo = 0, posNome = 0;
+        memset(&item, 0, sizeof(item));
+        // Tipo ou nome que não cabem no Item são recusados, nunca cortados
+        if (sscanf(argumentos, "%d %d %n%*s%n %n", &item.id, &item.raridade,
+                   &inicioTipo, &fimTipo, &posNome) < 2
+            || posNome == 0 || argumentos[posNome] == 0
+            || fimTipo - inicioTipo >= (int)sizeof(item.tipo)
+            || strlen(argumentos + posNome) >= sizeof(item.nome)
+            || item.id <= 0 || item.raridade < 1 || item.raridade > 5) {
+            printf("ERR inserir motivo=argumentos_invalidos\n");
+            return 0;
+        }
+        memcpy(item.tipo, argumentos + inicioTipo, (size_t)(fimTipo - inicioTipo));
+        strcpy(item.nome, argumentos + posNome);
+
+        ResultadoOperacao resultado = estrutura == 1 ? inserir_vetor(vetor, item)
+                                                     : inserir_lista(lista, item);
+        if (resultado == RESULTADO_OK) {
+            printf("OK inserir id=%d\n", item.id);
             return 1;
         }
-        temp = temp->proximo;
+        printf("ERR inserir id=%d motivo=%s\n", item.id, nome_resultado(resultado));
+        return 0;
     }
-    printf("Busca Linear (Lista): Item com ID %d nao encontrado.\n", id);
-    return 0;
-}
-
-/**
- * @brief Busca Binária no Vetor.
- * @param comparacoes Ponteiro para contar o número de comparações.
- * @return 1 se encontrado, 0 se não.
- */
-int busca_binaria_vetor(ListaVetor* lista, int id, int* comparacoes) {
-    *comparacoes = 0;
-    int inicio = 0;
-    int fim = lista->tamanho - 1;
 
-    while (inicio <= fim) {
-        int meio = inicio + (fim - inicio) / 2; // Evita overflow
-
-        (*comparacoes)++; // Conta a primeira checagem (igualdade)
-        if (lista->itens[meio].id == id) {
-            printf("Busca Binaria (Vetor): Item encontrado!\n");
-            exibir_item(lista->itens[meio]);
+    if (strcmp(comando, "remover") == 0) {
+        if (sscanf(argumentos, "%d", &id) != 1) {
+            printf("ERR remover motivo=argumentos_invalidos\n");
+            return 0;
+        }
+        ResultadoOperacao resultado = estrutura == 1 ? remover_vetor(vetor, id)
+                                                     : remover_lista(lista, id);
+        if (resultado == RESULTADO_OK) {
+            printf("OK remover id=%d\n", id);
             return 1;
         }
+        printf("ERR remover id=%d motivo=%s\n", id, nome_resultado(resultado));
+        return 0;
+    }
+
+    if (strcmp(comando, "buscar") == 0 || strcmp(comando, "buscar_binaria") == 0) {
+        int binaria = strcmp(comando, "buscar_binaria") == 0;
+        if (sscanf(argumentos, "%d", &id) != 1) {
+            printf("ERR %s motivo=argumentos_invalidos\n", comando);
+            return 0;
+        }
+        if (binaria && estrutura != 1) {
+            printf("ERR %s id=%d motivo=indisponivel\n", comando, id);
+            return 0;
+        }
+        if (binaria && !vetor->ordenadoPorID) {
+            printf("ERR %s id=%d motivo=nao_ordenado_por_id\n", comando, id);
+            return 0;
+        }
 
-        (*comparacoes)++; // Conta a segunda checagem (menor/maior)
-        if (lista->itens[meio].id < id) {
-            inicio = meio + 1;
+        Item encontrado;
+        int achou = 0;
+        if (estrutura == 1) {
+            int indice = binaria ? localizar_binaria_vetor(vetor, id, &comparacoes)
+                                 : localizar_linear_vetor(vetor, id, &comparacoes);
+            if (indice != -1) {
+                encontrado = vetor->itens[indice];
+                achou = 1;
+            }
         } else {
-            fim = meio - 1;
+            No* no = localizar_linear_lista(lista, id, &comparacoes);
+            if (no != NULL) {
+                encontrado = no->item;
+                achou = 1;
+            }
         }
-    }
 
-    printf("Busca Binaria (Vetor): Item com ID %d nao encontrado.\n", id);
-    return 0;
-}
+        if (!achou) {
+            printf("ERR %s id=%d comparacoes=%d motivo=nao_encontrado\n", comando, id, comparacoes);
+            return 0;
+        }
+        printf("OK %s comparacoes=%d ", comando, comparacoes);
+        responder_item(encontrado);
+        printf("\n");
+        return 1;
+    }
 
+    if (strcmp(comando, "ordenar") == 0) {
+        char chave[16] = "";
+        char algoritmo[16] = "insertion";
+        long comp = 0, trocas = 0;
 
-// --- 6. ALGORITMOS DE ORDENAÇÃO (VETOR) ---
-// Todos ordenam por RARIDADE (crescente)
+        if (sscanf(argumentos, "%15s %15s", chave, algoritmo) < 1) {
+            printf("ERR ordenar motivo=argumentos_invalidos\n");
+            return 0;
+        }
+        int chaveValida = strcmp(chave, "raridade") == 0 || strcmp(chave, "id") == 0
+                       || strcmp(chave, "nome") == 0;
+        int insertion = strcmp(algoritmo, "insertion") == 0;
+        if (!chaveValida || (!insertion && strcmp(algoritmo, "bubble") != 0
+                                        && strcmp(algoritmo, "selection") != 0)) {
+            printf("ERR ordenar chave=%s algoritmo=%s motivo=argumentos_invalidos\n", chave, algoritmo);
+            return 0;
+        }
+        // Bubble e Selection só existem para o vetor e só por raridade
+        if (!insertion && (estrutura == 2 || strcmp(chave, "raridade") != 0)) {
+            printf("ERR ordenar chave=%s algoritmo=%s motivo=indisponivel\n", chave, algoritmo);
+            return 0;
+        }
 
-/**
- * @brief Ordena o vetor por raridade usando Bubble Sort.
- */
-void bubbleSort(ListaVetor* lista, long* comparacoes, long* trocas) {
-    *comparacoes = 0;
-    *trocas = 0;
-    int n = lista->tamanho;
-    for (int i = 0; i < n - 1; i++) {
-        for (int j = 0; j < n - i - 1; j++) {
-            (*comparacoes)++;
-            if (lista->itens[j].raridade > lista->itens[j + 1].raridade) {
-                trocar(&lista->itens[j], &lista->itens[j + 1]);
-                (*trocas)++;
+        if (estrutura == 2) {
+            if (strcmp(chave, "raridade") == 0) {
+                ordenarListaPorRaridade(lista, &comp, &trocas);
+            } else if (strcmp(chave, "id") == 0) {
+                ordenarListaPorID(lista, &comp, &trocas);
+            } else {
+                ordenarListaPorNome(lista, &comp, &trocas);
             }
+        } else if (strcmp(chave, "id") == 0) {
+            ordenarPorID(vetor, &comp, &trocas);
+        } else if (strcmp(chave, "nome") == 0) {
+            ordenarPorNome(vetor, &comp, &trocas);
+        } else if (strcmp(algoritmo, "bubble") == 0) {
+            bubbleSort(vetor, &comp, &trocas);
+        } else if (strcmp(algoritmo, "selection") == 0) {
+            selectionSort(vetor, &comp, &trocas);
+        } else {
+            insertionSort(vetor, &comp, &trocas);
         }
+        printf("OK ordenar chave=%s algoritmo=%s comparacoes=%ld trocas=%ld\n",
+               chave, algoritmo, comp, trocas);
+        return 1;
     }
-    lista->ordenadoPorID = 0; // Lista foi ordenada por raridade
-}
 
-/**
- * @brief Ordena o vetor por raridade usando Selection Sort.
- */
-void selectionSort(ListaVetor* lista, long* comparacoes, long* trocas) {
-    *comparacoes = 0;
-    *trocas = 0;
-    int n = lista->tamanho;
-    for (int i = 0; i < n - 1; i++) {
-        int min_idx = i;
-        for (int j = i + 1; j < n; j++) {
-            (*comparacoes)++;
-            if (lista->itens[j].raridade < lista->itens[min_idx].raridade) {
-                min_idx = j;
+    if (strcmp(comando, "listar") == 0) {
+        int quantidade = 0;
+        if (estrutura == 1) {
+            quantidade = vetor->tamanho;
+        } else {
+            for (No* temp = *lista; temp != NULL; temp = temp->proximo) {
+                quantidade++;
             }
         }
-        if (min_idx != i) {
-            trocar(&lista->itens[i], &lista->itens[min_idx]);
-            (*trocas)++;
+        printf("OK listar quantidade=%d\n", quantidade);
+        if (estrutura == 1) {
+            for (int i = 0; i < vetor->tamanho; i++) {
+                printf("ITEM ");
+                responder_item(vetor->itens[i]);
+                printf("\n");
+            }
+        } else {
+            for (No* temp = *lista; temp != NULL; temp = temp->proximo) {
+                printf("ITEM ");
+                responder_item(temp->item);
+                printf("\n");
+            }
         }
+        return 1;
     }
-    lista->ordenadoPorID = 0; // Lista foi ordenada por raridade
-}
 
-/**
- * @brief Ordena o vetor por raridade usando Insertion Sort.
- */
-void insertionSort(ListaVetor* lista, long* comparacoes, long* trocas) {
-    *comparacoes = 0;
-    *trocas = 0;
-    int n = lista->tamanho;
-    for (int i = 1; i < n; i++) {
-        Item chave = lista->itens[i];
-        int j = i - 1;
-
-        /* Move os elementos de lista->itens[0..i-1] que são
-           maiores que a chave, para uma posição à frente */
-        while (j >= 0) {
-            (*comparacoes)++;
-            if (lista->itens[j].raridade > chave.raridade) {
-                lista->itens[j + 1] = lista->itens[j];
-                (*trocas)++; // Conta como uma "troca" ou "movimentação"
-                j = j - 1;
-            } else {
-                break; // Sai do while se a condição não for atendida
+    if (strcmp(comando, "politica") == 0 || strcmp(comando, "cache") == 0
+        || strcmp(comando, "estatisticas") == 0) {
+        const char* nomes[] = { "nenhuma", "mover_frente", "transpor", "contagem" };
+        char valor[16] = "";
+        sscanf(argumentos, "%15s", valor);
+        if (estrutura != 2) {
+            printf("ERR %s motivo=indisponivel\n", comando);
+            return 0;
+        }
+
+        if (strcmp(comando, "politica") == 0) {
+            for (int i = 0; i < 4; i++) {
+                if (strcmp(valor, nomes[i]) == 0) {
+                    autoOrg.politica = (PoliticaAutoOrganizacao)i;
+                    zerar_estatisticas_auto();
+                    printf("OK politica nome=%s\n", nomes[i]);
+                    return 1;
+                }
             }
+        } else if (strcmp(comando, "cache") == 0) {
+            if (strcmp(valor, "ligado") == 0 || strcmp(valor, "desligado") == 0) {
+                autoOrg.cacheAtivo = strcmp(valor, "ligado") == 0;
+                cache_limpar();
+                zerar_estatisticas_auto();
+                printf("OK cache estado=%s\n", valor);
+                return 1;
+            }
+        } else {
+            printf("OK estatisticas politica=%s cache=%s consultas=%ld encontrados=%ld acertos_cache=%ld"
+                   " taxa_acerto=%.4f comparacoes_media=%.2f\n",
+                   nomes[autoOrg.politica], autoOrg.cacheAtivo ? "ligado" : "desligado",
+                   autoOrg.consultas, autoOrg.encontrados, autoOrg.acertosCache,
+                   autoOrg.consultas > 0 ? (double)autoOrg.acertosCache / autoOrg.consultas : 0.0,
+                   autoOrg.consultas > 0 ? (double)autoOrg.comparacoesTotais / autoOrg.consultas : 0.0);
+            return 1;
         }
-        lista->itens[j + 1] = chave;
-        // (Opcional) Contar a inserção final como uma troca
-        // if(j != i - 1) (*trocas)++; 
+        printf("ERR %s motivo=argumentos_invalidos\n", comando);
+        return 0;
     }
-    lista->ordenadoPorID = 0; // Lista foi ordenada por raridade
+
+    if (strcmp(comando, "bloom") == 0) {
+        ResumoBloom resumo = resumir_bloom();
+        printf("OK bloom bytes=%ld bytes_bits=%ld bytes_por_item=%.2f consultas=%ld negativos=%ld"
+               " falsos_positivos=%ld taxa_fp=%.4f reconstrucoes=%ld\n",
+               resumo.bytes, resumo.bytesBits, resumo.bytesPorItem, filtroIds.consultas,
+               filtroIds.negativos, filtroIds.falsosPositivos, resumo.taxaFalsosPositivos,
+               filtroIds.reconstrucoes);
+        return 1;
+    }
+
+    if (strcmp(comando, "memoria") == 0) {
+        ResumoMemoria resumo = resumir_memoria(estrutura, vetor, *lista);
+        EstatisticasMemoria total = memoria_totais();
+        printf("OK memoria itens=%d bytes_estrutura=%ld bytes_dados=%ld bytes_controle=%ld"
+               " bytes_capacidade_livre=%ld bytes_overhead_malloc=%ld bytes_filtro=%ld bytes_total=%ld"
+               " bytes_por_item=%.2f alocacoes=%ld liberacoes=%ld heap_em_uso=%ld heap_pico=%ld"
+               " fragmentacao_heap=%.4f\n",
+               resumo.itens, resumo.bytesEstrutura, resumo.bytesDados, resumo.bytesControle,
+               resumo.bytesCapacidadeLivre, resumo.bytesOverheadMalloc, resumo.bytesFiltro,
+               resumo.bytesTotal, resumo.bytesPorItem, total.alocacoes, total.liberacoes,
+               total.bytesReais, total.picoReais, resumo.heapMedido ? resumo.fragmentacaoHeap : -1.0);
+        return 1;
+    }
+
+    if (strcmp(comando, "sincronizar") == 0) {
+        if (diarioAtivo != NULL && !diario_sincronizar(diarioAtivo)) {
+            printf("ERR sincronizar motivo=falha_diario\n");
+            return 0;
+        }
+        printf("OK sincronizar\n");
+        return 1;
+    }
+
+    if (strcmp(comando, "sair") == 0) {
+        printf("OK sair\n");
+        return -1;
+    }
+
+    printf("ERR %s motivo=comando_desconhecido\n", comando);
+    return 0;
 }
 
 /**
- * @brief Ordena o vetor por ID (necessário para Busca Binária).
- * Usaremos o Insertion Sort para esta tarefa.
+ * @brief Executa todos os comandos de um arquivo (ou stdin) até "sair" ou EOF.
+ * @param diario Diário já aberto para a estrutura, ou NULL para rodar só em memória.
+ * @return 0 se todos os comandos deram certo, 1 se algum falhou.
  */
-void ordenarPorID(ListaVetor* lista, long* comparacoes, long* trocas) {
-    *comparacoes = 0;
-    *trocas = 0;
-    int n = lista->tamanho;
-    for (int i = 1; i < n; i++) {
-        Item chave = lista->itens[i];
-        int j = i - 1;
-        while (j >= 0) {
-            (*comparacoes)++;
-            if (lista->itens[j].id > chave.id) {
-                lista->itens[j + 1] = lista->itens[j];
-                (*trocas)++;
-                j = j - 1;
-            } else {
-                break;
-            }
+int executar_comandos(FILE* entrada, int estrutura, ListaVetor* vetor, No** lista, Diario* diario) {
+    char linha[COMANDO_MAX_LINHA];
+    long comandos = 0;
+    long erros = 0;
+    double inicio = agora_segundos();
+
+    int silencioAnterior = modo_silencioso;
+    modo_silencioso = 1; // As respostas são só as linhas OK/ERR
+
+    while (fgets(linha, sizeof(linha), entrada) != NULL) {
+        int resultado;
+        if (strchr(linha, '\n') == NULL && !feof(entrada)) {
+            // Linha maior que o buffer: descarta o resto dela
+            int c;
+            while ((c = fgetc(entrada)) != '\n' && c != EOF);
+            printf("ERR linha motivo=linha_longa\n");
+            resultado = 0;
+        } else {
+            resultado = executar_comando(linha, estrutura, vetor, lista);
+        }
+
+        if (resultado == -1) {
+            break;
+        }
+        if (resultado == 0) {
+            erros++;
+        }
+        comandos++;
+
+        if (diario != NULL) {
+            persistencia_compactar_se_necessario(diario, vetor, *lista);
         }
-        lista->itens[j + 1] = chave;
     }
-    lista->ordenadoPorID = 1; // MARCA o vetor como ordenado por ID
+
+    if (diario != NULL) {
+        diario_descarregar(diario);
+    }
+    modo_silencioso = silencioAnterior;
+
+    printf("FIM comandos=%ld erros=%ld tempo_ms=%.2f heap_pico=%ld\n",
+           comandos, erros, (agora_segundos() - inicio) * 1000.0, memoriaPicoTotal);
+    fflush(stdout);
+    return erros > 0;
 }
 
 
-// --- 7. MENUS E FUNÇÃO PRINCIPAL ---
+// --- 12. MENUS E FUNÇÃO PRINCIPAL ---
 
 void exibir_menu_principal(int tipoLista) {
     printf("\n======= SISTEMA DE INVENTARIO RPG =======\n");
@@ -510,16 +2513,24 @@ void exibir_menu_principal(int tipoLista) {
     printf("3. Remover Item (por ID)\n");
     printf("4. Buscar Item (Busca Linear por ID)\n");
     
-    // Funções exclusivas do VETOR
+    // Funções exclusivas do VETOR (a lista só ordena com Insertion Sort)
     if (tipoLista == 1) {
         printf("5. Buscar Item (Busca Binaria por ID)\n");
         printf("6. Ordenar por Raridade (Bubble/Select/Insert)\n");
         printf("7. Preparar para Busca Binaria (Ordenar por ID)\n");
     } else {
         printf("5. (Indisponivel na Lista Encadeada)\n");
-        printf("6. (Indisponivel na Lista Encadeada)\n");
+        printf("6. Ordenar por Raridade (Insertion)\n");
         printf("7. (Indisponivel na Lista Encadeada)\n");
     }
+    printf("8. Persistencia (Diario / Snapshot)\n");
+    if (tipoLista == 2) {
+        printf("9. Auto-organizacao da Lista (Politica / Cache)\n");
+    } else {
+        printf("9. (Indisponivel no Vetor)\n");
+    }
+    printf("10. Filtro de Bloom (Estatisticas)\n");
+    printf("11. Relatorio de Memoria\n");
     printf("0. Sair\n");
     printf("=========================================\n");
     printf("Escolha uma opcao: ");
@@ -573,7 +2584,205 @@ void menu_ordenacao_raridade(ListaVetor* lista) {
     }
 }
 
-int main() {
+void menu_persistencia(Diario* diario, ListaVetor* vetor, No* lista) {
+    int escolha;
+    int operacoes;
+
+    printf("\n--- Persistencia (Diario / Snapshot) ---\n");
+    printf("Politica atual:       %s\n", nome_politica_fsync(diario->politica));
+    printf("Registros no diario:  %ld (+%d pendentes)\n", diario->registrosNoArquivo, diario->qtdPendentes);
+    printf("fsyncs realizados:    %ld\n", diario->fsyncs);
+    printf("1. Politica: sem fsync\n");
+    printf("2. Politica: fsync por lote (group commit)\n");
+    printf("3. Politica: fsync por operacao\n");
+    printf("4. Compactar agora (snapshot + limpar diario)\n");
+    printf("5. Benchmark de durabilidade\n");
+    printf("0. Voltar\n");
+    printf("Escolha: ");
+
+    if (scanf("%d", &escolha) != 1) {
+        escolha = -1; // Força opção inválida
+    }
+    limpar_buffer_stdin();
+
+    switch (escolha) {
+        case 1:
+        case 2:
+        case 3:
+            diario_descarregar(diario); // O lote pendente segue a política antiga
+            diario->politica = (PoliticaFsync)(escolha - 1);
+            printf("Politica alterada para: %s\n", nome_politica_fsync(diario->politica));
+            break;
+        case 4:
+            if (persistencia_compactar(diario, vetor, lista)) {
+                printf("Diario compactado em '%s'.\n", diario->caminhoSnapshot);
+            }
+            break;
+        case 5:
+            printf("Numero de mutacoes por politica: ");
+            if (scanf("%d", &operacoes) != 1 || operacoes <= 0) {
+                operacoes = 2000;
+            }
+            limpar_buffer_stdin();
+            benchmark_diario(operacoes);
+            break;
+        case 0:
+            printf("Voltando...\n");
+            break;
+        default:
+            printf("Opcao invalida!\n");
+            break;
+    }
+}
+
+void menu_auto_organizacao() {
+    int escolha;
+
+    printf("\n--- Auto-organizacao da Lista ---\n");
+    exibir_estatisticas_auto();
+    printf("\n1. Politica: nenhuma\n");
+    printf("2. Politica: mover para frente\n");
+    printf("3. Politica: transpor\n");
+    printf("4. Politica: contagem de acessos\n");
+    printf("5. Ligar/Desligar cache LRU\n");
+    printf("6. Zerar estatisticas\n");
+    printf("0. Voltar\n");
+    printf("Escolha: ");
+
+    if (scanf("%d", &escolha) != 1) {
+        escolha = -1; // Força opção inválida
+    }
+    limpar_buffer_stdin();
+
+    switch (escolha) {
+        case 1:
+        case 2:
+        case 3:
+        case 4:
+            autoOrg.politica = (PoliticaAutoOrganizacao)(escolha - 1);
+            zerar_estatisticas_auto(); // Estatísticas passam a valer para a nova política
+            printf("Politica alterada para: %s\n", nome_politica_auto(autoOrg.politica));
+            break;
+        case 5:
+            autoOrg.cacheAtivo = !autoOrg.cacheAtivo;
+            cache_limpar();
+            zerar_estatisticas_auto();
+            printf("Cache LRU %s.\n", autoOrg.cacheAtivo ? "ligado" : "desligado");
+            break;
+        case 6:
+            zerar_estatisticas_auto();
+            printf("Estatisticas zeradas.\n");
+            break;
+        case 0:
+            printf("Voltando...\n");
+            break;
+        default:
+            printf("Opcao invalida!\n");
+            break;
+    }
+}
+
+void exibir_uso(const char* programa) {
+    fprintf(stderr, "Uso: %s                       (menu interativo)\n", programa);
+    fprintf(stderr, "     %s --comandos <arquivo|-> [--estrutura vetor|lista]\n", programa);
+    fprintf(stderr, "        [--diario <base> [--fsync nunca|lote|sempre]]\n");
+    fprintf(stderr, "     Sem --diario o inventario fica so na memoria; com --diario usa\n");
+    fprintf(stderr, "     <base>.snap e <base>.wal.\n");
+}
+
+/**
+ * @brief Trata os argumentos de linha de comando e roda o modo de comandos.
+ * @return O código de saída do programa.
+ */
+int modo_comandos(int argc, char* argv[]) {
+    const char* caminho = "-";
+    int estrutura = 1;
+    const char* baseDiario = NULL; // NULL = só memória
+    int politicaInformada = 0;
+    PoliticaFsync politica = FSYNC_LOTE;
+
+    for (int i = 1; i < argc; i++) {
+        const char* valor = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(argv[i], "--comandos") == 0 && valor != NULL) {
+            caminho = valor;
+        } else if (strcmp(argv[i], "--estrutura") == 0 && valor != NULL && strcmp(valor, "vetor") == 0) {
+            estrutura = 1;
+        } else if (strcmp(argv[i], "--estrutura") == 0 && valor != NULL && strcmp(valor, "lista") == 0) {
+            estrutura = 2;
+        } else if (strcmp(argv[i], "--diario") == 0 && valor != NULL) {
+            baseDiario = valor;
+        } else if (strcmp(argv[i], "--fsync") == 0 && valor != NULL && strcmp(valor, "nunca") == 0) {
+            politica = FSYNC_NUNCA;
+            politicaInformada = 1;
+        } else if (strcmp(argv[i], "--fsync") == 0 && valor != NULL && strcmp(valor, "lote") == 0) {
+            politica = FSYNC_LOTE;
+            politicaInformada = 1;
+        } else if (strcmp(argv[i], "--fsync") == 0 && valor != NULL && strcmp(valor, "sempre") == 0) {
+            politica = FSYNC_SEMPRE;
+            politicaInformada = 1;
+        } else {
+            exibir_uso(argv[0]);
+            return 2;
+        }
+        i++; // Todas as opções têm um valor
+    }
+    if (politicaInformada && baseDiario == NULL) {
+        fprintf(stderr, "Erro: --fsync exige --diario.\n");
+        exibir_uso(argv[0]);
+        return 2;
+    }
+
+    FILE* entrada = stdin;
+    if (strcmp(caminho, "-") != 0) {
+        entrada = fopen(caminho, "r");
+        if (entrada == NULL) {
+            fprintf(stderr, "Erro: Nao foi possivel abrir '%s'.\n", caminho);
+            return 2;
+        }
+    }
+
+    static ListaVetor inventarioVetor; // static: evita ~9 KB na pilha
+    No* inventarioLista = NULL;
+    Diario diario;
+
+    modo_silencioso = 1;
+    if (estrutura == 1) {
+        inicializar_vetor(&inventarioVetor);
+    } else {
+        inicializar_lista(&inventarioLista);
+    }
+    if (baseDiario != NULL
+        && !persistencia_abrir(&diario, baseDiario, estrutura, &inventarioVetor, &inventarioLista,
+                               politica)) {
+        liberar_lista(&inventarioLista);
+        bloom_liberar();
+        if (entrada != stdin) {
+            fclose(entrada);
+        }
+        return 2;
+    }
+    modo_silencioso = 0;
+
+    int codigo = executar_comandos(entrada, estrutura, &inventarioVetor, &inventarioLista,
+                                   baseDiario != NULL ? &diario : NULL);
+
+    if (baseDiario != NULL) {
+        persistencia_fechar(&diario);
+    }
+    liberar_lista(&inventarioLista);
+    bloom_liberar();
+    if (entrada != stdin) {
+        fclose(entrada);
+    }
+    return codigo;
+}
+
+int main(int argc, char* argv[]) {
+    // Com argumentos: modo de comandos (sem menu, sem pausas)
+    if (argc > 1) {
+        return modo_comandos(argc, argv);
+    }
+
     int tipoLista = 0; // 1 = Vetor, 2 = Lista
     int escolha_menu = -1;
     int id_busca_remove;
@@ -583,6 +2792,7 @@ int main() {
     // Estruturas de dados
     ListaVetor inventarioVetor;
     No* inventarioLista = NULL; // Importante inicializar com NULL
+    Diario diario;
 
     // --- Escolha da Estrutura ---
     while (tipoLista != 1 && tipoLista != 2) {
@@ -607,6 +2817,14 @@ int main() {
             pausar();
         }
     }
+
+    // Reconstrói o inventário da execução anterior (snapshot + diário)
+    if (!persistencia_abrir(&diario, tipoLista == 1 ? "inventario_vetor" : "inventario_lista",
+                            tipoLista, &inventarioVetor, &inventarioLista, FSYNC_LOTE)) {
+        liberar_lista(&inventarioLista);
+        bloom_liberar();
+        return 1;
+    }
     
     pausar();
 
@@ -660,7 +2878,7 @@ int main() {
                 if (tipoLista == 1) {
                     busca_linear_vetor(&inventarioVetor, id_busca_remove, &comparacoes_busca);
                 } else {
-                    busca_linear_lista(inventarioLista, id_busca_remove, &comparacoes_busca);
+                    busca_linear_lista(&inventarioLista, id_busca_remove, &comparacoes_busca);
                 }
                 printf("Relatorio de Analise: Busca Linear realizou %d comparacoes.\n", comparacoes_busca);
                 break;
@@ -684,11 +2902,17 @@ int main() {
                 }
                 break;
 
-            case 6: // Ordenar por Raridade (Só Vetor)
+            case 6: // Ordenar por Raridade (lista: só Insertion Sort)
                 if (tipoLista == 1) {
                     menu_ordenacao_raridade(&inventarioVetor);
                 } else {
-                    printf("Opcao invalida para Lista Encadeada.\n");
+                    comp_ord = 0;
+                    trocas_ord = 0;
+                    ordenarListaPorRaridade(&inventarioLista, &comp_ord, &trocas_ord);
+                    printf("\nLista ordenada com Insertion Sort!\n");
+                    printf("Relatorio de Analise:\n");
+                    printf("- Comparacoes: %ld\n", comp_ord);
+                    printf("- Trocas:      %ld\n", trocas_ord);
                 }
                 break;
             
@@ -706,6 +2930,28 @@ int main() {
                 }
                 break;
 
+            case 8: // Persistência
+                menu_persistencia(&diario, &inventarioVetor, inventarioLista);
+                break;
+
+            case 9: // Auto-organização (Só Lista)
+                if (tipoLista == 2) {
+                    menu_auto_organizacao();
+                } else {
+                    printf("Opcao invalida para Vetor.\n");
+                }
+                break;
+
+            case 10: // Filtro de Bloom
+                printf("\n--- Filtro de Bloom dos IDs ---\n");
+                exibir_estatisticas_bloom();
+                break;
+
+            case 11: // Memória
+                printf("\n--- Relatorio de Memoria ---\n");
+                exibir_relatorio_memoria(tipoLista, &inventarioVetor, inventarioLista);
+                break;
+
             case 0: // Sair
                 printf("Saindo do sistema...\n");
                 break;
@@ -715,22 +2961,25 @@ int main() {
                 break;
         }
 
+        // No modo interativo não há mais nada para agrupar no lote:
+        // grava antes de esperar o usuário.
+        diario_descarregar(&diario);
+        persistencia_compactar_se_necessario(&diario, &inventarioVetor, inventarioLista);
+
         if(escolha_menu != 0) {
             pausar();
         }
 
     } while (escolha_menu != 0);
 
+    persistencia_fechar(&diario);
+
     // --- Limpeza de Memória (para Lista Encadeada) ---
     if (tipoLista == 2) {
-        No* temp = inventarioLista;
-        while (temp != NULL) {
-            No* proximo = temp->proximo;
-            free(temp);
-            temp = proximo;
-        }
+        liberar_lista(&inventarioLista);
         printf("Memoria da lista encadeada liberada.\n");
     }
+    bloom_liberar();
 
     return 0;
 }
@@ -788,4 +3037,4 @@ int main() {
  * listas pequenas ou quase ordenadas.
  *
  * =============================================================================
- */
\ No newline at end of file
+ */
\ No newline at end of file